@@ -119,6 +119,7 @@ class fire
 
             m_vga.blit(img);
             m_vga.show();
+            m_limiter.wait();
         }
     };
 
@@ -127,6 +128,7 @@ class fire
 
     retro::sdl2 m_sdl2{retro::sdl2::subsystem::video};
     retro::vga m_vga{retro::vga::mode::vga_13h};
+    retro::frame_limiter m_limiter{70.0};    // refresh rate of mode 13h
 };
 
 #endif  // FIRE_HPP
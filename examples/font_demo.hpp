@@ -44,6 +44,7 @@ class font_demo
             }
 
             m_vga.show();
+            m_limiter.wait();
         }
     };
 
@@ -52,6 +53,7 @@ class font_demo
 
     retro::sdl2 m_sdl2{retro::sdl2::subsystem::video};
     retro::vga m_vga{retro::vga::mode::vga_13h};
+    retro::frame_limiter m_limiter{70.0};    // refresh rate of mode 13h
 };
 
 #endif  // FONT_DEMO_HPP
@@ -0,0 +1,14 @@
+////////////////////////////////////////////////////////////////////////////////
+// Retro - Retro Computing Library
+// Copyright (c) 2023 Ryan Clarke
+////////////////////////////////////////////////////////////////////////////////
+
+#include "maze_fill.hpp"
+
+
+////////////////////////////////////////////////////////////////////////////////
+int main()
+{
+    maze_fill app;
+    app.run();
+}
@@ -0,0 +1,90 @@
+////////////////////////////////////////////////////////////////////////////////
+// Retro - Retro Computing Library
+// Copyright (c) 2023 Ryan Clarke
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef MAZE_FILL_HPP
+#define MAZE_FILL_HPP
+
+#include <retro/retro.hpp>
+#include <SDL2/SDL.h>
+
+#include <chrono>
+#include <ranges>
+#include <string>
+
+
+////////////////////////////////////////////////////////////////////////////////
+class maze_fill
+{
+  public:
+    maze_fill()
+    {
+        // serpentine maze of one pixel wide corridors, the worst case for a
+        // span-stack fill: every scanline is cut into many short spans
+        m_vga.clear(0);
+
+        for(const auto x : std::views::iota(0, width) | std::views::filter([](int x) { return x % 2 == 1; }))
+        {
+            const auto gap = ((x / 2) % 2 == 0) ? 0 : height - 1;
+
+            for(const auto y : std::views::iota(0, height))
+            {
+                if(y != gap)
+                {
+                    m_vga.set_pixel(x, y, wall);
+                }
+            }
+        }
+
+        m_running = true;
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    void run()
+    {
+        while(m_running)
+        {
+            for(SDL_Event e; SDL_PollEvent(&e);)
+            {
+                if(e.type == SDL_QUIT)
+                {
+                    m_running = false;
+                }
+            }
+
+            m_fill = (m_fill == 2) ? 3 : 2;
+
+            const auto start = std::chrono::steady_clock::now();
+            m_vga.flood_fill(0, 0, m_fill);
+            const auto elapsed = std::chrono::steady_clock::now() - start;
+
+            m_total += elapsed;
+            ++m_frames;
+
+            const auto average = std::chrono::duration<double, std::micro>(m_total).count() /
+                                 static_cast<double>(m_frames);
+            const auto text = "flood fill: " + std::to_string(static_cast<int>(average)) + " us   ";
+            m_vga.print(text, 0, 24, 15, false);
+
+            m_vga.show();
+            m_limiter.wait();
+        }
+    };
+
+  private:
+    static constexpr int width{320};
+    static constexpr int height{192};
+    static constexpr int wall{1};
+
+    bool m_running{false};
+    int m_fill{2};
+    int m_frames{0};
+    std::chrono::steady_clock::duration m_total{};
+
+    retro::sdl2 m_sdl2{retro::sdl2::subsystem::video};
+    retro::vga m_vga{retro::vga::mode::vga_13h};
+    retro::frame_limiter m_limiter{70.0};    // refresh rate of mode 13h
+};
+
+#endif  // MAZE_FILL_HPP
@@ -0,0 +1,14 @@
+////////////////////////////////////////////////////////////////////////////////
+// Retro - Retro Computing Library
+// Copyright (c) 2023 Ryan Clarke
+////////////////////////////////////////////////////////////////////////////////
+
+#include "mode_switch.hpp"
+
+
+////////////////////////////////////////////////////////////////////////////////
+int main()
+{
+    mode_switch app;
+    app.run();
+}
@@ -0,0 +1,75 @@
+////////////////////////////////////////////////////////////////////////////////
+// Retro - Retro Computing Library
+// Copyright (c) 2023 Ryan Clarke
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef MODE_SWITCH_HPP
+#define MODE_SWITCH_HPP
+
+#include <retro/retro.hpp>
+#include <SDL2/SDL.h>
+
+#include <chrono>
+#include <string>
+
+
+////////////////////////////////////////////////////////////////////////////////
+class mode_switch
+{
+  public:
+    mode_switch()
+    {
+        // draw each mode once; the cached buffers keep the screens afterwards
+        m_vga.set_mode(retro::vga::mode::vga_03h);
+        m_vga.print("text mode", 0, 0, 15, false);
+        m_vga.set_mode(retro::vga::mode::vga_13h);
+        m_vga.fill_circle(160, 100, 80, 4);
+
+        m_running = true;
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    void run()
+    {
+        while(m_running)
+        {
+            for(SDL_Event e; SDL_PollEvent(&e);)
+            {
+                if(e.type == SDL_QUIT)
+                {
+                    m_running = false;
+                }
+            }
+
+            m_text = !m_text;
+            const auto next = m_text ? retro::vga::mode::vga_03h : retro::vga::mode::vga_13h;
+
+            const auto start = std::chrono::steady_clock::now();
+            m_vga.set_mode(next);
+            const auto elapsed = std::chrono::steady_clock::now() - start;
+
+            m_total += elapsed;
+            ++m_switches;
+
+            const auto average = std::chrono::duration<double, std::micro>(m_total).count() /
+                                 static_cast<double>(m_switches);
+            const auto text = "mode switch: " + std::to_string(static_cast<int>(average)) + " us   ";
+            m_vga.print(text, 0, m_text ? 2 : 24, 15, false);
+
+            m_vga.show();
+            m_limiter.wait();
+        }
+    };
+
+  private:
+    bool m_running{false};
+    bool m_text{false};
+    int m_switches{0};
+    std::chrono::steady_clock::duration m_total{};
+
+    retro::sdl2 m_sdl2{retro::sdl2::subsystem::video};
+    retro::vga m_vga{retro::vga::mode::vga_13h};
+    retro::frame_limiter m_limiter{70.0};    // refresh rate of mode 13h
+};
+
+#endif  // MODE_SWITCH_HPP
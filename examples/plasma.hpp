@@ -9,12 +9,11 @@
 #include <retro/retro.hpp>
 #include <SDL2/SDL.h>
 
-#include <algorithm>
 #include <array>
+#include <chrono>
 #include <cmath>
 #include <cstddef>
 #include <numbers>
-#include <ranges>
 
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -52,6 +51,7 @@ class plasma
         }
 
         m_vga.blit(img);
+        m_vga.cycle(0, 255, std::chrono::milliseconds{10});
 
         m_running = true;
     };
@@ -69,9 +69,8 @@ class plasma
                 }
             }
 
-            std::ranges::rotate(m_palette, m_palette.begin() + 1);
-            m_vga.set_palette(m_palette);
             m_vga.show();
+            m_limiter.wait();
         }
     };
 
@@ -80,6 +79,7 @@ class plasma
 
     retro::sdl2 m_sdl2{retro::sdl2::subsystem::video};
     retro::vga m_vga{retro::vga::mode::vga_13h};
+    retro::frame_limiter m_limiter{70.0};    // refresh rate of mode 13h
     std::array<retro::color, 256> m_palette;
 };
 
@@ -55,6 +55,7 @@ class xor_demo
             }
 
             m_vga.show();
+            m_limiter.wait();
         }
     };
 
@@ -63,6 +64,7 @@ class xor_demo
 
     retro::sdl2 m_sdl2{retro::sdl2::subsystem::video};
     retro::vga m_vga{retro::vga::mode::vga_13h};
+    retro::frame_limiter m_limiter{70.0};    // refresh rate of mode 13h
 };
 
 
@@ -0,0 +1,115 @@
+////////////////////////////////////////////////////////////////////////////////
+// Retro - Retro Computing Library
+// Copyright (c) 2023 Ryan Clarke
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef RETRO_ATLAS_HPP
+#define RETRO_ATLAS_HPP
+
+#include <retro/rect.hpp>
+
+#include <functional>
+#include <map>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+
+////////////////////////////////////////////////////////////////////////////////
+namespace retro
+{
+
+////////////////////////////////////////////////////////////////////////////////
+/// \brief Sprite sheet holding many named frames in one pixel buffer.
+////////////////////////////////////////////////////////////////////////////////
+class atlas
+{
+  public:
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Create an atlas.
+    /// \param width width in pixels
+    /// \param height height in pixels
+    /// \param pixels pixel data [optional]
+    ////////////////////////////////////////////////////////////////////////////
+    atlas(int width, int height, const std::optional<std::span<const int>>& pixels = std::nullopt);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Copy constructor.
+    /// \param copy instance to copy
+    ////////////////////////////////////////////////////////////////////////////
+    atlas(const atlas& copy) = default;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Overload of assignment operator.
+    /// \param right instance to assign
+    ////////////////////////////////////////////////////////////////////////////
+    atlas& operator=(const atlas& right) = default;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Move constructor.
+    /// \param other instance to move
+    ////////////////////////////////////////////////////////////////////////////
+    atlas(atlas&& other) = default;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Overload of assignment operator.
+    /// \param other instance to move
+    ////////////////////////////////////////////////////////////////////////////
+    atlas& operator=(atlas&& other) = default;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Add a named frame.
+    /// \param name frame name
+    /// \param frame frame rectangle within the atlas
+    ////////////////////////////////////////////////////////////////////////////
+    void add_frame(std::string name, const rect& frame);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Set the transparent color key.
+    /// \param key palette index treated as transparent, or std::nullopt
+    ////////////////////////////////////////////////////////////////////////////
+    void color_key(std::optional<int> key);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Get the transparent color key.
+    /// \return palette index treated as transparent, if any
+    ////////////////////////////////////////////////////////////////////////////
+    [[nodiscard]] std::optional<int> color_key() const noexcept;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Get a named frame.
+    /// \param name frame name
+    /// \return frame rectangle within the atlas
+    ////////////////////////////////////////////////////////////////////////////
+    [[nodiscard]] rect frame(std::string_view name) const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Get atlas pixels
+    /// \return pixels
+    ////////////////////////////////////////////////////////////////////////////
+    [[nodiscard]] const std::vector<int>& pixels() const noexcept;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Get atlas size
+    /// \return size of atlas (width, height)
+    ////////////////////////////////////////////////////////////////////////////
+    [[nodiscard]] std::pair<int, int> size() const noexcept;
+
+    atlas() = delete;
+
+  private:
+    int m_width{};
+    int m_height{};
+    std::optional<int> m_color_key;
+
+    std::vector<int> m_texture;
+    std::map<std::string, rect, std::less<>> m_frames;
+};
+
+}   // retro
+
+
+#endif  // RETRO_ATLAS_HPP
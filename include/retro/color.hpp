@@ -223,6 +223,31 @@ class color
 }
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// \brief Linearly interpolate between two colors.
+/// \param a start color
+/// \param b end color
+/// \param t interpolation factor (0.0-1.0)
+/// \return interpolated color
+////////////////////////////////////////////////////////////////////////////////
+[[nodiscard]] constexpr color lerp(const color& a, const color& b, double t)
+{
+    t = (t < 0.0) ? 0.0 : ((t > 1.0) ? 1.0 : t);
+
+    const auto argb_a = a.to_argb();
+    const auto argb_b = b.to_argb();
+
+    const auto channel = [=](const int shift)
+    {
+        const auto ca = static_cast<double>((argb_a >> shift) & 0xffu);
+        const auto cb = static_cast<double>((argb_b >> shift) & 0xffu);
+        return static_cast<int>(ca + (cb - ca) * t + 0.5);
+    };
+
+    return color{channel(16), channel(8), channel(0)};
+}
+
+
 ////////////////////////////////////////////////////////////////////////////////
 constexpr color::color(const int r, const int g, const int b)
 {
@@ -0,0 +1,125 @@
+////////////////////////////////////////////////////////////////////////////////
+// Retro - Retro Computing Library
+// Copyright (c) 2023 Ryan Clarke
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef RETRO_COMPILED_SPRITE_HPP
+#define RETRO_COMPILED_SPRITE_HPP
+
+#include <cstddef>
+#include <span>
+#include <utility>
+#include <vector>
+
+
+////////////////////////////////////////////////////////////////////////////////
+namespace retro
+{
+
+////////////////////////////////////////////////////////////////////////////////
+class sprite;
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// \brief Run-length encoded sprite storing only its opaque pixels.
+///
+/// Each row is a list of runs. A run skips a number of transparent pixels,
+/// then copies a number of opaque pixels from the packed pixel data.
+////////////////////////////////////////////////////////////////////////////////
+class compiled_sprite
+{
+  public:
+    struct run
+    {
+        int skip{};                 // transparent pixels before the run
+        int count{};                // opaque pixels in the run
+        std::size_t data{};         // offset of the run in the pixel data
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Compile a sprite. Pixels matching the sprite's color key are
+    /// dropped; a sprite without a color key compiles to one run per row.
+    /// \param source source sprite
+    ////////////////////////////////////////////////////////////////////////////
+    explicit compiled_sprite(const sprite& source);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Copy constructor.
+    /// \param copy instance to copy
+    ////////////////////////////////////////////////////////////////////////////
+    compiled_sprite(const compiled_sprite& copy) = default;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Overload of assignment operator.
+    /// \param right instance to assign
+    ////////////////////////////////////////////////////////////////////////////
+    compiled_sprite& operator=(const compiled_sprite& right) = default;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Move constructor.
+    /// \param other instance to move
+    ////////////////////////////////////////////////////////////////////////////
+    compiled_sprite(compiled_sprite&& other) = default;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Overload of assignment operator.
+    /// \param other instance to move
+    ////////////////////////////////////////////////////////////////////////////
+    compiled_sprite& operator=(compiled_sprite&& other) = default;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Move sprite by a given offset.
+    /// \param dx x offset
+    /// \param dy y offset
+    ////////////////////////////////////////////////////////////////////////////
+    void move(int dx, int dy) noexcept;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Get the packed opaque pixels.
+    /// \return pixels
+    ////////////////////////////////////////////////////////////////////////////
+    [[nodiscard]] std::span<const int> pixels() const noexcept;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Set sprite position.
+    /// \param x x coordinate
+    /// \param y y coordinate
+    ////////////////////////////////////////////////////////////////////////////
+    void position(int x, int y) noexcept;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Get sprite position
+    /// \return (x,y) coordinate
+    ////////////////////////////////////////////////////////////////////////////
+    [[nodiscard]] std::pair<int, int> position() const noexcept;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Get the runs of a row.
+    /// \param row row of the sprite
+    /// \return runs
+    ////////////////////////////////////////////////////////////////////////////
+    [[nodiscard]] std::span<const run> runs(int row) const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Get sprite size
+    /// \return size of sprite (width, height)
+    ////////////////////////////////////////////////////////////////////////////
+    [[nodiscard]] std::pair<int, int> size() const noexcept;
+
+    compiled_sprite() = delete;
+
+  private:
+    int m_width{};
+    int m_height{};
+    int m_x{};
+    int m_y{};
+
+    std::vector<std::size_t> m_rows;    // index of the first run of each row
+    std::vector<run> m_runs;
+    std::vector<int> m_pixels;
+};
+
+}   // retro
+
+
+#endif  // RETRO_COMPILED_SPRITE_HPP
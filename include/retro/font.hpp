@@ -7,7 +7,10 @@
 #define RETRO_FONT_HPP
 
 #include <cstddef>
+#include <filesystem>
+#include <memory>
 #include <span>
+#include <stdexcept>
 #include <utility>
 #include <vector>
 
@@ -16,22 +19,66 @@
 namespace retro
 {
 
+////////////////////////////////////////////////////////////////////////////////
+/// \brief Bitmap font. A font is a view of its glyph data: copies share the
+/// same glyphs, either borrowed from static storage or owned jointly.
+///
+/// Glyphs are stored one after another. Each row of a glyph takes
+/// (width + 7) / 8 bytes, with the leftmost pixel in the most significant bit
+/// of the first byte.
 ////////////////////////////////////////////////////////////////////////////////
 class font
 {
   public:
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Tag selecting the constructor that borrows glyph data.
+    ////////////////////////////////////////////////////////////////////////////
+    struct borrow_t
+    {
+        explicit borrow_t() = default;
+    };
+
+    static constexpr borrow_t borrow{};
+
     ////////////////////////////////////////////////////////////////////////////
     /// \brief Create empty font.
     ////////////////////////////////////////////////////////////////////////////
     font() = default;
 
     ////////////////////////////////////////////////////////////////////////////
-    /// \brief Create font from glyph data.
+    /// \brief Create font viewing glyph data without copying it. The glyph
+    /// data must outlive the font and all of its copies, as static glyph
+    /// tables do.
+    /// \param glyphs font glyphs
+    /// \param width glyph width (1-32 pixels)
+    /// \param height glyph height (pixels)
+    /// \param spacing blank columns right of each glyph (pixels)
+    ////////////////////////////////////////////////////////////////////////////
+    constexpr font(borrow_t, std::span<const std::byte> glyphs, int width, int height, int spacing = 0);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Create font from a copy of glyph data. Copies of the font share
+    /// the copy. A font wider than 8 pixels without spacing needs more than
+    /// 256 * height bytes of glyphs; an 8 pixel font with a blank 9th column
+    /// is width 8 with spacing 1.
     /// \param glyphs font glyphs
-    /// \param width glyph width (pixels)
+    /// \param width glyph width (1-32 pixels)
     /// \param height glyph height (pixels)
+    /// \param spacing blank columns right of each glyph (pixels)
     ////////////////////////////////////////////////////////////////////////////
-    font(std::span<const std::byte> glyphs, int width, int height);
+    font(std::span<const std::byte> glyphs, int width, int height, int spacing = 0);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Create font owning its glyph data. Copies of the font share the
+    /// glyph data. A font wider than 8 pixels without spacing needs more than
+    /// 256 * height bytes of glyphs; an 8 pixel font with a blank 9th column
+    /// is width 8 with spacing 1.
+    /// \param glyphs font glyphs
+    /// \param width glyph width (1-32 pixels)
+    /// \param height glyph height (pixels)
+    /// \param spacing blank columns right of each glyph (pixels)
+    ////////////////////////////////////////////////////////////////////////////
+    font(std::vector<std::byte> glyphs, int width, int height, int spacing = 0);
 
     ////////////////////////////////////////////////////////////////////////////
     /// \brief Copy constructor.
@@ -58,27 +105,177 @@ class font
     font& operator=(font&& other) = default;
 
     ////////////////////////////////////////////////////////////////////////////
-    /// \brief Get glyph from font.
-    /// \param c character code
+    /// \brief Get number of glyphs in the font.
+    /// \return number of glyphs
+    ////////////////////////////////////////////////////////////////////////////
+    [[nodiscard]] constexpr int count() const noexcept;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Get glyph from font. Glyphs missing from the font are blank.
+    /// \param index glyph index
     /// \param fg foreground color
     /// \param bg background color
     /// \return pixelized glyph
     ////////////////////////////////////////////////////////////////////////////
-    [[nodiscard]] std::vector<int> glyph(unsigned char c, int fg, int bg) const;
+    [[nodiscard]] std::vector<int> glyph(int index, int fg, int bg) const;
 
     ////////////////////////////////////////////////////////////////////////////
-    /// \brief Get size of font glyphs.
+    /// \brief Map a code point to a glyph. Fonts are laid out as CP437 unless
+    /// loaded with a Unicode mapping. Code points without a glyph map to '?'.
+    /// \param c code point
+    /// \return glyph index
+    ////////////////////////////////////////////////////////////////////////////
+    [[nodiscard]] int index(char32_t c) const noexcept;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Load a BDF font. Glyphs are indexed by their encoding, taken to
+    /// be Unicode, and are placed in the cell given by the font bounding box.
+    /// \param path BDF file
+    /// \return font
+    ////////////////////////////////////////////////////////////////////////////
+    [[nodiscard]] static font load_bdf(const std::filesystem::path& path);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Load a PSF1 or PSF2 console font. The file is memory mapped and
+    /// the font views its glyphs in place. The Unicode table of the font, if
+    /// any, maps code points to glyphs.
+    /// \param path PSF file
+    /// \return font
+    ////////////////////////////////////////////////////////////////////////////
+    [[nodiscard]] static font load_psf(const std::filesystem::path& path);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Load a raw dump of 8 pixel wide glyphs, such as a character
+    /// generator ROM. The file is memory mapped and the font views its glyphs
+    /// in place.
+    /// \param path font file
+    /// \param height glyph height (pixels)
+    /// \return font
+    ////////////////////////////////////////////////////////////////////////////
+    [[nodiscard]] static font load_raw(const std::filesystem::path& path, int height);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Get the bit rows of a glyph, stride() bytes per row.
+    /// \param index glyph index
+    /// \return glyph rows, empty if the glyph is missing
+    ////////////////////////////////////////////////////////////////////////////
+    [[nodiscard]] std::span<const std::byte> rows(int index) const noexcept;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Get size of font glyphs, including spacing.
     /// \return size of font glyphs (width, height)
     ////////////////////////////////////////////////////////////////////////////
-    [[nodiscard]] std::pair<int, int> size() const noexcept;
+    [[nodiscard]] constexpr std::pair<int, int> size() const noexcept;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Get the blank columns right of each glyph.
+    /// \return spacing (pixels)
+    ////////////////////////////////////////////////////////////////////////////
+    [[nodiscard]] constexpr int spacing() const noexcept;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Get the bytes per glyph row.
+    /// \return stride (bytes)
+    ////////////////////////////////////////////////////////////////////////////
+    [[nodiscard]] constexpr int stride() const noexcept;
 
   private:
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Create font viewing glyph data.
+    /// \param glyphs font glyphs
+    /// \param width glyph width (1-32 pixels)
+    /// \param height glyph height (pixels)
+    /// \param spacing blank columns right of each glyph (pixels)
+    /// \param glyph_size bytes per glyph, at least stride * height, or 0 for
+    /// stride * height
+    ////////////////////////////////////////////////////////////////////////////
+    constexpr font(std::span<const std::byte> glyphs, int width, int height, int spacing, std::size_t glyph_size);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Create font sharing ownership of glyph data.
+    /// \param glyphs font glyphs
+    /// \param owner owner of the glyph data
+    /// \param width glyph width (1-32 pixels)
+    /// \param height glyph height (pixels)
+    /// \param spacing blank columns right of each glyph (pixels)
+    /// \param glyph_size bytes per glyph, at least stride * height
+    ////////////////////////////////////////////////////////////////////////////
+    font(std::span<const std::byte> glyphs, std::shared_ptr<const void> owner, int width, int height,
+         int spacing, std::size_t glyph_size);
+
     int m_width{};
     int m_height{};
+    int m_spacing{};
+    int m_stride{};
+    std::size_t m_glyph_size{};
+
+    std::span<const std::byte> m_glyphs;
+    std::shared_ptr<const void> m_owner;        // empty if borrowed
 
-    std::vector<std::byte> m_glyphs;
+    bool m_unicode{false};                      // glyphs indexed by code point
+    std::shared_ptr<const std::vector<std::pair<char32_t, int>>> m_unicode_map;    // sorted by code point
 };
 
+
+////////////////////////////////////////////////////////////////////////////////
+constexpr font::font(borrow_t, const std::span<const std::byte> glyphs, const int width, const int height,
+                     const int spacing)
+    : font{glyphs, width, height, spacing, 0}
+{
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+constexpr font::font(const std::span<const std::byte> glyphs, const int width, const int height,
+                     const int spacing, const std::size_t glyph_size)
+    : m_width{width}, m_height{height}, m_spacing{spacing}, m_stride{(width + 7) / 8}, m_glyphs{glyphs}
+{
+    if(width < 1 || width > 32 || height < 1 || spacing < 0)
+    {
+        throw std::invalid_argument("font ctor has an invalid argument");
+    }
+
+    m_glyph_size = static_cast<std::size_t>(m_stride * m_height);
+
+    if(glyph_size != 0)
+    {
+        if(glyph_size < m_glyph_size)
+        {
+            throw std::invalid_argument("font ctor has an invalid argument");
+        }
+
+        m_glyph_size = glyph_size;
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+constexpr int font::count() const noexcept
+{
+    return (m_glyph_size == 0) ? 0 : static_cast<int>(m_glyphs.size() / m_glyph_size);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+constexpr std::pair<int, int> font::size() const noexcept
+{
+    return {m_width + m_spacing, m_height};
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+constexpr int font::spacing() const noexcept
+{
+    return m_spacing;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+constexpr int font::stride() const noexcept
+{
+    return m_stride;
+}
+
 }   // retro
 
 
@@ -0,0 +1,87 @@
+////////////////////////////////////////////////////////////////////////////////
+// Retro - Retro Computing Library
+// Copyright (c) 2023 Ryan Clarke
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef RETRO_FRAME_LIMITER_HPP
+#define RETRO_FRAME_LIMITER_HPP
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+
+
+////////////////////////////////////////////////////////////////////////////////
+namespace retro
+{
+
+////////////////////////////////////////////////////////////////////////////////
+/// \brief Paces a frame loop to a target rate, independent of vsync.
+///
+/// Frames are scheduled on fixed deadlines. wait() sleeps through most of the
+/// time left and spins, yielding, for the last part, which the scheduler
+/// cannot time precisely; the spin margin adapts to how late sleeps wake up.
+/// A frame later than its deadline starts the next one immediately, and a
+/// frame later than a whole period restarts the schedule rather than
+/// rushing to catch up.
+////////////////////////////////////////////////////////////////////////////////
+class frame_limiter
+{
+  public:
+    struct pacing
+    {
+        std::chrono::nanoseconds mean{};        // mean frame time
+        std::chrono::nanoseconds min{};         // shortest frame time
+        std::chrono::nanoseconds max{};         // longest frame time
+        std::chrono::nanoseconds jitter{};      // standard deviation of the frame time
+        std::size_t missed{};                   // frames that missed their deadline
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Create a frame limiter.
+    /// \param rate target rate (frames per second)
+    ////////////////////////////////////////////////////////////////////////////
+    explicit frame_limiter(double rate);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Get the frame period.
+    /// \return frame period
+    ////////////////////////////////////////////////////////////////////////////
+    [[nodiscard]] std::chrono::nanoseconds period() const noexcept;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Restart the schedule and the statistics.
+    ////////////////////////////////////////////////////////////////////////////
+    void reset() noexcept;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Get frame time statistics over the last frames, and the frames
+    /// missed since the last reset.
+    /// \return frame pacing
+    ////////////////////////////////////////////////////////////////////////////
+    [[nodiscard]] pacing stats() const noexcept;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Wait for the start of the next frame. The first call starts the
+    /// schedule and returns immediately.
+    ////////////////////////////////////////////////////////////////////////////
+    void wait();
+
+  private:
+    using clock = std::chrono::steady_clock;
+
+    clock::duration m_period{};
+    clock::duration m_margin{};                 // time spun before a deadline
+    clock::time_point m_deadline;               // start of the next frame
+    clock::time_point m_last;                   // start of the current frame
+
+    std::array<clock::duration, 120> m_samples{};   // ring of the last frame times
+    std::size_t m_num_samples{};
+    std::size_t m_next_sample{};
+    std::size_t m_missed{};
+};
+
+}   // retro
+
+
+#endif  // RETRO_FRAME_LIMITER_HPP
@@ -0,0 +1,28 @@
+////////////////////////////////////////////////////////////////////////////////
+// Retro - Retro Computing Library
+// Copyright (c) 2023 Ryan Clarke
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef RETRO_RECT_HPP
+#define RETRO_RECT_HPP
+
+
+////////////////////////////////////////////////////////////////////////////////
+namespace retro
+{
+
+////////////////////////////////////////////////////////////////////////////////
+struct rect
+{
+    int x{};
+    int y{};
+    int width{};
+    int height{};
+
+    bool operator==(const rect&) const = default;
+};
+
+}   // retro
+
+
+#endif  // RETRO_RECT_HPP
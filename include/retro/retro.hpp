@@ -6,10 +6,19 @@
 #ifndef RETRO_HPP
 #define RETRO_HPP
 
+#include <retro/atlas.hpp>
 #include <retro/color.hpp>
+#include <retro/compiled_sprite.hpp>
 #include <retro/font.hpp>
+#include <retro/frame_limiter.hpp>
+#include <retro/rect.hpp>
+#include <retro/scrollback.hpp>
 #include <retro/sdl2.hpp>
 #include <retro/sprite.hpp>
+#include <retro/sprite_batch.hpp>
+#include <retro/terminal.hpp>
+#include <retro/trace.hpp>
+#include <retro/tui.hpp>
 #include <retro/vga.hpp>
 
 
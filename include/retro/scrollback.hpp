@@ -0,0 +1,141 @@
+////////////////////////////////////////////////////////////////////////////////
+// Retro - Retro Computing Library
+// Copyright (c) 2023 Ryan Clarke
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef RETRO_SCROLLBACK_HPP
+#define RETRO_SCROLLBACK_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+
+////////////////////////////////////////////////////////////////////////////////
+namespace retro
+{
+
+////////////////////////////////////////////////////////////////////////////////
+/// \brief Character cell of the text screen.
+////////////////////////////////////////////////////////////////////////////////
+struct text_cell
+{
+    std::uint16_t glyph{};                      // glyph index
+    std::uint8_t fg{};                          // foreground color
+    std::uint8_t bg{};                          // background color
+
+    bool operator==(const text_cell&) const = default;
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// \brief Ring buffer of text lines scrolled off the screen.
+///
+/// Lines are stored compactly, one record after another in a byte ring:
+/// trailing empty cells are dropped, glyphs take one byte each, and colors
+/// are stored as runs of cells sharing the same attributes. Appending a line
+/// never moves the others; when the ring is full the oldest lines are
+/// dropped. The byte ring grows only when the bytes of the held lines do not
+/// fit, to twice their size.
+////////////////////////////////////////////////////////////////////////////////
+class scrollback
+{
+  public:
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Create scrollback holding no lines.
+    ////////////////////////////////////////////////////////////////////////////
+    scrollback() = default;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Create scrollback.
+    /// \param depth maximum number of lines held
+    ////////////////////////////////////////////////////////////////////////////
+    explicit scrollback(std::size_t depth);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Remove all lines.
+    ////////////////////////////////////////////////////////////////////////////
+    void clear() noexcept;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Get maximum number of lines held.
+    /// \return depth (lines)
+    ////////////////////////////////////////////////////////////////////////////
+    [[nodiscard]] std::size_t depth() const noexcept;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Get a line.
+    /// \param age line number, 0 being the most recent line
+    /// \param cells cells of the line, cells past the end of the line are
+    /// left empty
+    ////////////////////////////////////////////////////////////////////////////
+    void line(std::size_t age, std::span<text_cell> cells) const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Get memory used by the line records.
+    /// \return memory used (bytes)
+    ////////////////////////////////////////////////////////////////////////////
+    [[nodiscard]] std::size_t memory_usage() const noexcept;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Append a line, dropping the oldest line if the scrollback is
+    /// full.
+    /// \param cells cells of the line
+    ////////////////////////////////////////////////////////////////////////////
+    void push(std::span<const text_cell> cells);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Get number of lines held.
+    /// \return number of lines
+    ////////////////////////////////////////////////////////////////////////////
+    [[nodiscard]] std::size_t size() const noexcept;
+
+  private:
+    // each record is its glyph bytes followed by its runs of
+    // (length, fg, bg, glyph high byte)
+    static constexpr std::size_t run_size{4};
+
+    struct record
+    {
+        std::uint32_t offset{};                 // offset of the record in the byte ring
+        std::uint16_t glyphs{};                 // number of cells
+        std::uint16_t runs{};                   // number of attribute runs
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Remove the oldest line.
+    ////////////////////////////////////////////////////////////////////////////
+    void drop() noexcept;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Grow the byte ring, laying the records out from its start.
+    /// \param needed bytes needed after the last record
+    ////////////////////////////////////////////////////////////////////////////
+    void grow(std::size_t needed);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Get a line record.
+    /// \param i position of the line, 0 being the oldest line
+    /// \return line record
+    ////////////////////////////////////////////////////////////////////////////
+    [[nodiscard]] const record& nth(std::size_t i) const noexcept;
+
+    std::vector<record> m_lines;                // ring of line records
+    std::size_t m_first{};                      // ring position of the oldest line
+    std::size_t m_count{};
+
+    // the record bytes in use are [m_tail, m_head), or [m_tail, m_end) and
+    // [0, m_head) once records have wrapped to the start of the ring
+    std::vector<std::uint8_t> m_data;           // ring of record bytes
+    std::size_t m_head{};                       // offset of the next record
+    std::size_t m_tail{};                       // offset of the oldest non-empty record
+    std::size_t m_end{};                        // end of the records before the wrap
+    std::size_t m_used{};                       // bytes of the held records
+    bool m_wrapped{false};
+};
+
+}   // retro
+
+
+#endif  // RETRO_SCROLLBACK_HPP
@@ -58,6 +58,18 @@ class sprite
     ////////////////////////////////////////////////////////////////////////////
     void fill(int color);
 
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Set the transparent color key.
+    /// \param key palette index treated as transparent, or std::nullopt
+    ////////////////////////////////////////////////////////////////////////////
+    void color_key(std::optional<int> key);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Get the transparent color key.
+    /// \return palette index treated as transparent, if any
+    ////////////////////////////////////////////////////////////////////////////
+    [[nodiscard]] std::optional<int> color_key() const noexcept;
+
     ////////////////////////////////////////////////////////////////////////////
     /// \brief Move sprite by a given offset.
     /// \param dx x offset
@@ -97,6 +109,7 @@ class sprite
     int m_height{};
     int m_x{};
     int m_y{};
+    std::optional<int> m_color_key;
 
     std::vector<int> m_texture;
 };
@@ -0,0 +1,137 @@
+////////////////////////////////////////////////////////////////////////////////
+// Retro - Retro Computing Library
+// Copyright (c) 2023 Ryan Clarke
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef RETRO_SPRITE_BATCH_HPP
+#define RETRO_SPRITE_BATCH_HPP
+
+#include <retro/rect.hpp>
+
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+
+////////////////////////////////////////////////////////////////////////////////
+namespace retro
+{
+
+////////////////////////////////////////////////////////////////////////////////
+class atlas;
+class sprite;
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// \brief Frame-level display list of sprites.
+///
+/// Entries reference the pixels of their sprite or atlas, which must outlive
+/// the batch. Entries are drawn in ascending z order; entries with equal z
+/// are grouped by source image, keeping submission order within a group.
+////////////////////////////////////////////////////////////////////////////////
+class sprite_batch
+{
+  public:
+    enum class flags : unsigned
+    {
+        none   = 0u,
+        hidden = 1u << 0,       // entry is culled
+        opaque = 1u << 1        // color key is ignored
+    };
+
+    struct entry
+    {
+        std::span<const int> pixels;        // source image
+        int pitch{};                        // width of the source image
+        rect source;                        // source rectangle within the image
+        int x{};                            // x location on screen
+        int y{};                            // y location on screen
+        int z{};                            // draw order
+        std::optional<int> key;             // transparent color key
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Create an empty batch.
+    ////////////////////////////////////////////////////////////////////////////
+    sprite_batch() = default;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Add a sprite at its own position.
+    /// \param source source sprite
+    /// \param z draw order
+    /// \param f entry flags
+    ////////////////////////////////////////////////////////////////////////////
+    void add(const sprite& source, int z = 0, flags f = flags::none);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Add a frame of an atlas.
+    /// \param source source atlas
+    /// \param frame source rectangle within the atlas
+    /// \param x x location on screen
+    /// \param y y location on screen
+    /// \param z draw order
+    /// \param f entry flags
+    ////////////////////////////////////////////////////////////////////////////
+    void add(const atlas& source, const rect& frame, int x, int y, int z = 0, flags f = flags::none);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Remove all entries, keeping the allocated storage.
+    ////////////////////////////////////////////////////////////////////////////
+    void clear() noexcept;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Get batch entries in submission order.
+    /// \return entries
+    ////////////////////////////////////////////////////////////////////////////
+    [[nodiscard]] std::span<const entry> entries() const noexcept;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Reserve storage for a number of entries.
+    /// \param count number of entries
+    ////////////////////////////////////////////////////////////////////////////
+    void reserve(std::size_t count);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Get number of entries.
+    /// \return number of entries
+    ////////////////////////////////////////////////////////////////////////////
+    [[nodiscard]] std::size_t size() const noexcept;
+
+  private:
+    std::vector<entry> m_entries;
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// \brief Overload of bit-wise OR operator.
+/// \param lhs left operand
+/// \param rhs right operand
+/// \return Result of \a lhs | \a rhs
+////////////////////////////////////////////////////////////////////////////////
+[[nodiscard]] constexpr sprite_batch::flags operator|(const sprite_batch::flags lhs,
+                                                      const sprite_batch::flags rhs) noexcept
+{
+    using type = std::underlying_type_t<sprite_batch::flags>;
+    return sprite_batch::flags{static_cast<type>(lhs) | static_cast<type>(rhs)};
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// \brief Overload of bit-wise AND operator.
+/// \param lhs left operand
+/// \param rhs right operand
+/// \return Result of \a lhs & \a rhs
+////////////////////////////////////////////////////////////////////////////////
+[[nodiscard]] constexpr sprite_batch::flags operator&(const sprite_batch::flags lhs,
+                                                      const sprite_batch::flags rhs) noexcept
+{
+    using type = std::underlying_type_t<sprite_batch::flags>;
+    return sprite_batch::flags{static_cast<type>(lhs) & static_cast<type>(rhs)};
+}
+
+}   // retro
+
+
+#endif  // RETRO_SPRITE_BATCH_HPP
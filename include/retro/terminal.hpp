@@ -0,0 +1,236 @@
+////////////////////////////////////////////////////////////////////////////////
+// Retro - Retro Computing Library
+// Copyright (c) 2023 Ryan Clarke
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef RETRO_TERMINAL_HPP
+#define RETRO_TERMINAL_HPP
+
+#include <retro/font.hpp>
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+
+////////////////////////////////////////////////////////////////////////////////
+namespace retro
+{
+
+////////////////////////////////////////////////////////////////////////////////
+class vga;
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// \brief ANSI/VT100 terminal emulator drawing to the text screen of a VGA
+/// device.
+///
+/// Output is parsed incrementally: escape and UTF-8 sequences may be split
+/// across calls to write(), which never allocates. Characters go to a buffer
+/// of character cells; render() draws the rows that changed. The terminal
+/// takes the text screen size of the current video mode at construction.
+///
+/// Supported: SGR colors (bold, reverse, 30-37, 40-47, 90-97, 100-107),
+/// cursor movement and positioning (A-H, d, f, s, u, ESC 7, ESC 8), erase
+/// (J, K, X), insert and delete (@, P, L, M), scrolling (S, T, ESC D, ESC M)
+/// and scroll regions (r), newline mode (20h, 20l) and reset (ESC c).
+////////////////////////////////////////////////////////////////////////////////
+class terminal
+{
+  public:
+    enum class charset
+    {
+        cp437,                                  // bytes are glyph indices, as ANSI.SYS
+        utf8                                    // UTF-8 mapped by the font
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Create a terminal on the text screen of a VGA device.
+    /// \param display VGA device, which must outlive the terminal
+    /// \param input input character set
+    ////////////////////////////////////////////////////////////////////////////
+    explicit terminal(vga& display, charset input = charset::utf8);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Get cursor position.
+    /// \return cursor position (column, row)
+    ////////////////////////////////////////////////////////////////////////////
+    [[nodiscard]] std::pair<int, int> cursor() const noexcept;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Set the function called for each BEL character.
+    /// \param f bell function
+    ////////////////////////////////////////////////////////////////////////////
+    void on_bell(std::function<void()> f);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Draw the rows changed since the last render.
+    ////////////////////////////////////////////////////////////////////////////
+    void render();
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Reset the terminal to its initial state and clear the screen.
+    ////////////////////////////////////////////////////////////////////////////
+    void reset();
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Write output to the terminal.
+    /// \param bytes output bytes
+    ////////////////////////////////////////////////////////////////////////////
+    void write(std::string_view bytes);
+
+    terminal() = delete;
+    terminal(const terminal&) = delete;
+    terminal(terminal&&) = delete;
+    terminal& operator=(const terminal&) = delete;
+    terminal& operator=(terminal&&) = delete;
+
+  private:
+    enum class state
+    {
+        ground,
+        escape,
+        escape_charset,                         // ESC ( and friends, skip one byte
+        csi,
+        osc                                     // operating system command, skipped
+    };
+
+    struct cell
+    {
+        int glyph{};
+        std::uint8_t fg{};
+        std::uint8_t bg{};
+    };
+
+    struct attributes
+    {
+        int fg{7};
+        int bg{0};
+        bool bold{false};
+        bool reverse{false};
+    };
+
+    static constexpr std::size_t max_params{16};
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Get an empty cell in the current colors.
+    /// \return blank cell
+    ////////////////////////////////////////////////////////////////////////////
+    [[nodiscard]] cell blank() const noexcept;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Execute a C0 control character.
+    /// \param c control character
+    ////////////////////////////////////////////////////////////////////////////
+    void control(unsigned char c);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Execute a complete CSI sequence.
+    /// \param final final byte of the sequence
+    ////////////////////////////////////////////////////////////////////////////
+    void csi_dispatch(unsigned char final);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Blank a range of cells.
+    /// \param first first cell
+    /// \param last last cell (exclusive)
+    ////////////////////////////////////////////////////////////////////////////
+    void erase(int first, int last);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Execute the byte following ESC.
+    /// \param c escape sequence byte
+    ////////////////////////////////////////////////////////////////////////////
+    void escape_dispatch(unsigned char c);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Move the cursor down a line, scrolling at the bottom of the
+    /// scroll region.
+    ////////////////////////////////////////////////////////////////////////////
+    void line_feed();
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Move the cursor, clamped to the screen.
+    /// \param col column
+    /// \param row row
+    ////////////////////////////////////////////////////////////////////////////
+    void move_to(int col, int row);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Get a CSI parameter.
+    /// \param i parameter number
+    /// \param fallback value of a missing or zero parameter
+    /// \return parameter value
+    ////////////////////////////////////////////////////////////////////////////
+    [[nodiscard]] int param(std::size_t i, int fallback) const noexcept;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Write a glyph at the cursor and advance the cursor.
+    /// \param glyph glyph index
+    ////////////////////////////////////////////////////////////////////////////
+    void put(int glyph);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Scroll rows down, blanking the rows scrolled in at the top.
+    /// \param top first row
+    /// \param bottom last row (inclusive)
+    /// \param lines number of lines
+    ////////////////////////////////////////////////////////////////////////////
+    void scroll_down(int top, int bottom, int lines);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Scroll rows up, blanking the rows scrolled in at the bottom.
+    /// \param top first row
+    /// \param bottom last row (inclusive)
+    /// \param lines number of lines
+    ////////////////////////////////////////////////////////////////////////////
+    void scroll_up(int top, int bottom, int lines);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Apply the SGR parameters to the current attributes.
+    ////////////////////////////////////////////////////////////////////////////
+    void select_graphic_rendition();
+
+    vga& m_vga;
+    font m_font;
+    charset m_charset;
+    int m_columns{};
+    int m_rows{};
+
+    std::vector<cell> m_cells;
+    std::vector<std::uint8_t> m_dirty;          // rows changed since the last render
+    std::array<int, 128> m_ascii{};             // glyph of each ASCII character
+    int m_space{};
+    int m_replacement{};
+
+    state m_state{state::ground};
+    std::array<int, max_params> m_params{};
+    std::size_t m_num_params{};
+    bool m_private{false};                      // CSI sequence starts with '?'
+
+    char32_t m_code_point{};                    // UTF-8 sequence being decoded
+    int m_utf8_remaining{};
+    char32_t m_utf8_min{};
+
+    int m_col{};
+    int m_row{};
+    bool m_wrap_pending{false};                 // last column written, wrap on next character
+    int m_top{};                                // scroll region (inclusive)
+    int m_bottom{};
+    bool m_newline_mode{true};                  // LF also returns the carriage
+    attributes m_attr;
+
+    int m_saved_col{};
+    int m_saved_row{};
+    attributes m_saved_attr;
+
+    std::function<void()> m_bell;
+};
+
+}   // retro
+
+
+#endif  // RETRO_TERMINAL_HPP
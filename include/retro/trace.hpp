@@ -0,0 +1,91 @@
+////////////////////////////////////////////////////////////////////////////////
+// Retro - Retro Computing Library
+// Copyright (c) 2023 Ryan Clarke
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef RETRO_TRACE_HPP
+#define RETRO_TRACE_HPP
+
+#include <chrono>
+#include <filesystem>
+#include <ostream>
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// \brief Timeline of scoped zones, exported as Chrome trace-event JSON that
+/// loads in Perfetto or chrome://tracing.
+///
+/// Each thread records its zones into its own ring buffer without locking;
+/// when a ring is full the oldest zones are dropped. Zones are recorded only
+/// when the library is built with RETRO_ENABLE_TRACE, otherwise they compile
+/// to nothing and the exported trace is empty.
+////////////////////////////////////////////////////////////////////////////////
+namespace retro::trace
+{
+
+////////////////////////////////////////////////////////////////////////////////
+/// \brief Zone recorded from its construction to its destruction.
+////////////////////////////////////////////////////////////////////////////////
+class zone
+{
+  public:
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Start a zone.
+    /// \param name zone name, which must be a string with static storage such
+    /// as a literal
+    ////////////////////////////////////////////////////////////////////////////
+    explicit zone(const char* name) noexcept;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Record the zone.
+    ////////////////////////////////////////////////////////////////////////////
+    ~zone();
+
+    zone(const zone&) = delete;
+    zone& operator=(const zone&) = delete;
+
+#ifdef RETRO_ENABLE_TRACE
+  private:
+    const char* m_name;
+    std::chrono::steady_clock::time_point m_start;
+#endif
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// \brief Drop the zones recorded so far by all threads.
+////////////////////////////////////////////////////////////////////////////////
+void clear() noexcept;
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// \brief Save the recorded zones to a file as Chrome trace-event JSON.
+/// \param path file path
+////////////////////////////////////////////////////////////////////////////////
+void save(const std::filesystem::path& path);
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// \brief Write the recorded zones as Chrome trace-event JSON.
+/// \param os output stream
+////////////////////////////////////////////////////////////////////////////////
+void write(std::ostream& os);
+
+
+#ifndef RETRO_ENABLE_TRACE
+////////////////////////////////////////////////////////////////////////////////
+inline zone::zone(const char*) noexcept
+{
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+inline zone::~zone()
+{
+}
+#endif
+
+}   // retro::trace
+
+
+#endif  // RETRO_TRACE_HPP
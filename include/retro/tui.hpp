@@ -0,0 +1,563 @@
+////////////////////////////////////////////////////////////////////////////////
+// Retro - Retro Computing Library
+// Copyright (c) 2023 Ryan Clarke
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef RETRO_TUI_HPP
+#define RETRO_TUI_HPP
+
+#include <retro/rect.hpp>
+#include <retro/scrollback.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+
+////////////////////////////////////////////////////////////////////////////////
+namespace retro
+{
+
+////////////////////////////////////////////////////////////////////////////////
+class vga;
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// \brief Retained-mode text user interface.
+///
+/// Widgets form a tree owned by a screen. The screen composes the widgets
+/// into an off-screen grid of character cells and draws only the cells that
+/// differ from the previous frame. Text is CP437, as drawn by the built-in
+/// fonts.
+////////////////////////////////////////////////////////////////////////////////
+namespace tui
+{
+
+////////////////////////////////////////////////////////////////////////////////
+enum class frame_style
+{
+    none,
+    single,                                     // ┌─┐
+    double_line                                 // ╔═╗
+};
+
+enum class key
+{
+    up,
+    down,
+    left,
+    right,
+    home,
+    end,
+    page_up,
+    page_down,
+    backspace,
+    del,
+    enter
+};
+
+struct style
+{
+    int fg{15};                                 // text color
+    int bg{1};                                  // background color
+    int select_fg{0};                           // selected or focused text color
+    int select_bg{7};                           // selected or focused background color
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// \brief Clipped drawing surface over a grid of character cells.
+////////////////////////////////////////////////////////////////////////////////
+class canvas
+{
+  public:
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Create canvas covering a cell grid.
+    /// \param cells cell grid
+    /// \param columns width of the grid
+    /// \param rows height of the grid
+    ////////////////////////////////////////////////////////////////////////////
+    canvas(std::span<text_cell> cells, int columns, int rows) noexcept;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Fill a rectangle.
+    /// \param area rectangle (cells)
+    /// \param c fill cell
+    ////////////////////////////////////////////////////////////////////////////
+    void fill(const rect& area, const text_cell& c) noexcept;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Draw a frame around the edge of a rectangle.
+    /// \param area rectangle (cells)
+    /// \param frame frame style
+    /// \param fg frame color
+    /// \param bg background color
+    ////////////////////////////////////////////////////////////////////////////
+    void frame(const rect& area, frame_style frame, int fg, int bg) noexcept;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Get height.
+    /// \return height (cells)
+    ////////////////////////////////////////////////////////////////////////////
+    [[nodiscard]] int height() const noexcept;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Set a cell.
+    /// \param x column
+    /// \param y row
+    /// \param c cell
+    ////////////////////////////////////////////////////////////////////////////
+    void put(int x, int y, const text_cell& c) noexcept;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Get a canvas covering a rectangle of this one, clipped to it.
+    /// \param area rectangle (cells)
+    /// \return canvas with its origin at the rectangle
+    ////////////////////////////////////////////////////////////////////////////
+    [[nodiscard]] canvas sub(const rect& area) const noexcept;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Draw text on one row.
+    /// \param x column
+    /// \param y row
+    /// \param s CP437 text
+    /// \param fg text color
+    /// \param bg background color
+    /// \param width cells to fill, padding with spaces, or -1 for the text only
+    ////////////////////////////////////////////////////////////////////////////
+    void text(int x, int y, std::string_view s, int fg, int bg, int width = -1) noexcept;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Get width.
+    /// \return width (cells)
+    ////////////////////////////////////////////////////////////////////////////
+    [[nodiscard]] int width() const noexcept;
+
+  private:
+    std::span<text_cell> m_cells;
+    int m_pitch{};
+    int m_x{};                                  // origin in the grid
+    int m_y{};
+    int m_width{};
+    int m_height{};
+    rect m_clip;                                // visible part in the grid
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// \brief Element of the user interface. A widget draws itself and then its
+/// children, which are placed relative to its client area and clipped to it.
+////////////////////////////////////////////////////////////////////////////////
+class widget
+{
+  public:
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Create widget.
+    /// \param bounds location and size relative to the parent (cells)
+    ////////////////////////////////////////////////////////////////////////////
+    explicit widget(const rect& bounds);
+
+    virtual ~widget() = default;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Create a child widget.
+    /// \param args arguments of the widget constructor
+    /// \return child widget, owned by this widget
+    ////////////////////////////////////////////////////////////////////////////
+    template<typename W, typename... Args>
+    W& add(Args&&... args);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Get location and size.
+    /// \return bounds relative to the parent (cells)
+    ////////////////////////////////////////////////////////////////////////////
+    [[nodiscard]] const rect& bounds() const noexcept;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Move and resize.
+    /// \param bounds location and size relative to the parent (cells)
+    ////////////////////////////////////////////////////////////////////////////
+    void move(const rect& bounds) noexcept;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Handle a character typed while the widget has the focus.
+    /// \param c CP437 character
+    /// \return true if the character was handled
+    ////////////////////////////////////////////////////////////////////////////
+    virtual bool on_char(char c);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Handle a key pressed while the widget has the focus.
+    /// \param k key
+    /// \return true if the key was handled
+    ////////////////////////////////////////////////////////////////////////////
+    virtual bool on_key(key k);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Set colors.
+    /// \param s colors
+    ////////////////////////////////////////////////////////////////////////////
+    void set_style(const style& s) noexcept;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Show or hide the widget and its children.
+    /// \param visible true to show
+    ////////////////////////////////////////////////////////////////////////////
+    void set_visible(bool visible) noexcept;
+
+    widget(const widget&) = delete;
+    widget(widget&&) = delete;
+    widget& operator=(const widget&) = delete;
+    widget& operator=(widget&&) = delete;
+
+  protected:
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Get the area of the children.
+    /// \return client area relative to the widget (cells)
+    ////////////////////////////////////////////////////////////////////////////
+    [[nodiscard]] virtual rect client() const noexcept;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Draw the widget.
+    /// \param c canvas covering the widget
+    /// \param focused true if the widget has the focus
+    ////////////////////////////////////////////////////////////////////////////
+    virtual void draw(canvas& c, bool focused) const = 0;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Mark the widget as changed, so the screen composes the next
+    /// frame.
+    ////////////////////////////////////////////////////////////////////////////
+    void invalidate() noexcept;
+
+    style m_style;
+
+  private:
+    friend class screen;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Check if the widget or a child changed, and clear the flags.
+    /// \return true if changed
+    ////////////////////////////////////////////////////////////////////////////
+    [[nodiscard]] bool take_changed() noexcept;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Draw the widget and its children.
+    /// \param c canvas covering the parent's client area
+    /// \param focus widget with the focus
+    ////////////////////////////////////////////////////////////////////////////
+    void render(const canvas& c, const widget* focus) const;
+
+    rect m_bounds;
+    bool m_visible{true};
+    bool m_changed{true};
+    std::vector<std::unique_ptr<widget>> m_children;
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// \brief Window filled with its background color, with an optional frame and
+/// title.
+////////////////////////////////////////////////////////////////////////////////
+class window : public widget
+{
+  public:
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Create window.
+    /// \param bounds location and size relative to the parent (cells)
+    /// \param title title shown in the top edge of the frame
+    /// \param frame frame style
+    ////////////////////////////////////////////////////////////////////////////
+    window(const rect& bounds, std::string title, frame_style frame = frame_style::single);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Set title.
+    /// \param title title shown in the top edge of the frame
+    ////////////////////////////////////////////////////////////////////////////
+    void set_title(std::string title);
+
+  protected:
+    [[nodiscard]] rect client() const noexcept override;
+    void draw(canvas& c, bool focused) const override;
+
+  private:
+    std::string m_title;
+    frame_style m_frame;
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// \brief Single line of text.
+////////////////////////////////////////////////////////////////////////////////
+class label : public widget
+{
+  public:
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Create label.
+    /// \param bounds location and size relative to the parent (cells)
+    /// \param text CP437 text
+    ////////////////////////////////////////////////////////////////////////////
+    label(const rect& bounds, std::string text);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Set text.
+    /// \param text CP437 text
+    ////////////////////////////////////////////////////////////////////////////
+    void set_text(std::string text);
+
+  protected:
+    void draw(canvas& c, bool focused) const override;
+
+  private:
+    std::string m_text;
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// \brief Scrolling list of items with a selection, such as a menu.
+////////////////////////////////////////////////////////////////////////////////
+class list : public widget
+{
+  public:
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Create list.
+    /// \param bounds location and size relative to the parent (cells)
+    /// \param items CP437 items
+    ////////////////////////////////////////////////////////////////////////////
+    list(const rect& bounds, std::vector<std::string> items);
+
+    bool on_key(key k) override;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Get the selected item.
+    /// \return index of the selected item
+    ////////////////////////////////////////////////////////////////////////////
+    [[nodiscard]] std::size_t selected() const noexcept;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Set items, keeping the selection if it is still valid.
+    /// \param items CP437 items
+    ////////////////////////////////////////////////////////////////////////////
+    void set_items(std::vector<std::string> items);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Select an item and scroll it into view.
+    /// \param index index of the item, clamped to the items
+    ////////////////////////////////////////////////////////////////////////////
+    void select(std::size_t index);
+
+  protected:
+    void draw(canvas& c, bool focused) const override;
+
+  private:
+    std::vector<std::string> m_items;
+    std::size_t m_selected{};
+    std::size_t m_top{};                        // first visible item
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// \brief Table with a header row and fixed-width columns separated by lines.
+////////////////////////////////////////////////////////////////////////////////
+class table : public widget
+{
+  public:
+    struct column
+    {
+        std::string title;
+        int width{};                            // cells
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Create table.
+    /// \param bounds location and size relative to the parent (cells)
+    /// \param columns columns
+    ////////////////////////////////////////////////////////////////////////////
+    table(const rect& bounds, std::vector<column> columns);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Append a row.
+    /// \param cells CP437 text of each column
+    ////////////////////////////////////////////////////////////////////////////
+    void add_row(std::vector<std::string> cells);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Remove all rows.
+    ////////////////////////////////////////////////////////////////////////////
+    void clear_rows() noexcept;
+
+    bool on_key(key k) override;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Set the text of a table cell.
+    /// \param row row
+    /// \param col column
+    /// \param text CP437 text
+    ////////////////////////////////////////////////////////////////////////////
+    void set_cell(std::size_t row, std::size_t col, std::string text);
+
+  protected:
+    void draw(canvas& c, bool focused) const override;
+
+  private:
+    std::vector<column> m_columns;
+    std::vector<std::vector<std::string>> m_rows;
+    std::size_t m_top{};                        // first visible row
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// \brief Single line text input.
+////////////////////////////////////////////////////////////////////////////////
+class input_field : public widget
+{
+  public:
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Create input field.
+    /// \param bounds location and size relative to the parent (cells)
+    /// \param max_length maximum length of the text
+    ////////////////////////////////////////////////////////////////////////////
+    input_field(const rect& bounds, std::size_t max_length);
+
+    bool on_char(char c) override;
+    bool on_key(key k) override;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Set text, moving the cursor to its end.
+    /// \param text CP437 text, truncated to the maximum length
+    ////////////////////////////////////////////////////////////////////////////
+    void set_text(std::string text);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Get text.
+    /// \return CP437 text
+    ////////////////////////////////////////////////////////////////////////////
+    [[nodiscard]] const std::string& text() const noexcept;
+
+  protected:
+    void draw(canvas& c, bool focused) const override;
+
+  private:
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Scroll the text to keep the cursor visible.
+    ////////////////////////////////////////////////////////////////////////////
+    void scroll_to_cursor() noexcept;
+
+    std::string m_text;
+    std::size_t m_max_length;
+    std::size_t m_cursor{};
+    std::size_t m_scroll{};                     // first visible character
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// \brief Root of the widget tree, covering the text screen of a VGA device.
+////////////////////////////////////////////////////////////////////////////////
+class screen
+{
+  public:
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Create screen covering the text screen of the current video
+    /// mode.
+    /// \param display VGA device, which must outlive the screen
+    /// \param background cell shown where no widget is drawn
+    ////////////////////////////////////////////////////////////////////////////
+    explicit screen(vga& display, const text_cell& background = {' ', 7, 0});
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Create a top-level widget. Later widgets are drawn on top of
+    /// earlier ones.
+    /// \param args arguments of the widget constructor
+    /// \return widget, owned by the screen
+    ////////////////////////////////////////////////////////////////////////////
+    template<typename W, typename... Args>
+    W& add(Args&&... args);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Redraw every cell on the next render, after VRAM was changed
+    /// by other means.
+    ////////////////////////////////////////////////////////////////////////////
+    void invalidate() noexcept;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Pass a typed character to the widget with the focus.
+    /// \param c CP437 character
+    /// \return true if the character was handled
+    ////////////////////////////////////////////////////////////////////////////
+    bool on_char(char c);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Pass a key to the widget with the focus.
+    /// \param k key
+    /// \return true if the key was handled
+    ////////////////////////////////////////////////////////////////////////////
+    bool on_key(key k);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Draw the cells that changed since the last render. If no widget
+    /// changed the frame is not composed at all.
+    /// \return number of cells drawn
+    ////////////////////////////////////////////////////////////////////////////
+    std::size_t render();
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Give a widget the focus.
+    /// \param w widget, or nullptr for none
+    ////////////////////////////////////////////////////////////////////////////
+    void set_focus(widget* w) noexcept;
+
+    screen(const screen&) = delete;
+    screen(screen&&) = delete;
+    screen& operator=(const screen&) = delete;
+    screen& operator=(screen&&) = delete;
+
+  private:
+    vga& m_vga;
+    int m_columns{};
+    int m_rows{};
+    text_cell m_background;
+
+    std::vector<std::unique_ptr<widget>> m_widgets;
+    widget* m_focus{nullptr};
+    bool m_changed{true};
+
+    std::vector<text_cell> m_back;              // frame being composed
+    std::vector<text_cell> m_front;             // frame on screen
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+template<typename W, typename... Args>
+W& widget::add(Args&&... args)
+{
+    auto child = std::make_unique<W>(std::forward<Args>(args)...);
+    auto& ref = *child;
+    m_children.push_back(std::move(child));
+    m_changed = true;
+
+    return ref;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+template<typename W, typename... Args>
+W& screen::add(Args&&... args)
+{
+    auto w = std::make_unique<W>(std::forward<Args>(args)...);
+    auto& ref = *w;
+    m_widgets.push_back(std::move(w));
+    m_changed = true;
+
+    return ref;
+}
+
+}   // tui
+
+}   // retro
+
+
+#endif  // RETRO_TUI_HPP
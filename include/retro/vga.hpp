@@ -7,11 +7,19 @@
 #define RETRO_VGA_HPP
 
 #include <retro/font.hpp>
+#include <retro/rect.hpp>
+#include <retro/scrollback.hpp>
 
+#include <array>
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
+#include <map>
+#include <memory>
+#include <optional>
 #include <span>
 #include <string_view>
+#include <utility>
 #include <vector>
 
 
@@ -27,8 +35,16 @@ namespace retro
 {
 
 ////////////////////////////////////////////////////////////////////////////////
+class atlas;
 class color;
+class compiled_sprite;
 class sprite;
+class sprite_batch;
+
+namespace detail
+{
+class worker_pool;
+}
 
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -45,11 +61,68 @@ class vga
         vga_13h
     };
 
+    enum class init
+    {
+        immediate,                              // create the window in the constructor
+        deferred                                // create the window in the first show()
+    };
+
+    enum class raster_op
+    {
+        copy,                                   // replace destination
+        logical_and,                            // destination AND source
+        logical_or,                             // destination OR source
+        logical_xor,                            // destination XOR source
+        add                                     // destination + source, wrapped to the palette
+    };
+
+    enum class cursor_shape
+    {
+        none,
+        underline,                              // bottom two scanlines of the cell
+        block                                   // whole cell
+    };
+
+    enum class vsync
+    {
+        off,
+        on,
+        adaptive                                // late frames are shown without waiting, where supported
+    };
+
+    static constexpr int fixed_one{1 << 16};    // 1.0 in 16.16 fixed point
+
+    struct transform
+    {
+        bool flip_x{false};                     // mirror horizontally
+        bool flip_y{false};                     // mirror vertically
+        int scale_x{fixed_one};                 // horizontal scale (16.16 fixed point)
+        int scale_y{fixed_one};                 // vertical scale (16.16 fixed point)
+        double angle{0.0};                      // rotation about the center (radians)
+    };
+
+    struct frame_stats
+    {
+        std::chrono::nanoseconds convert{};     // converting VRAM to ARGB
+        std::chrono::nanoseconds upload{};      // in SDL_UpdateTexture
+        std::chrono::nanoseconds render_copy{}; // in SDL_RenderCopy
+        std::chrono::nanoseconds present{};     // in SDL_RenderPresent
+        std::size_t pixels_converted{};
+        std::size_t bytes_uploaded{};
+        std::size_t blits{};                    // images blitted, sprite batch entries counted singly
+        std::size_t glyphs{};                   // glyphs drawn by the application
+        std::size_t dirty_rects{};              // rectangles uploaded, 0 for a full frame
+        std::size_t allocations{};              // heap allocations since the previous frame
+    };
+
     ////////////////////////////////////////////////////////////////////////////
-    /// \brief Create a VGA device.
+    /// \brief Create a VGA device. With deferred initialization VRAM, palette
+    /// and font are usable immediately, and the window, renderer and texture
+    /// are created by the first call to show().
     /// \param video_mode standard video mode
+    /// \param policy when to create the window
     ////////////////////////////////////////////////////////////////////////////
-    explicit vga(mode video_mode);
+    explicit vga(mode video_mode, init policy = init::immediate);
 
     ////////////////////////////////////////////////////////////////////////////
     /// \brief Destroy the associated window, renderer, and texture.
@@ -65,14 +138,197 @@ class vga
     ////////////////////////////////////////////////////////////////////////////
     /// \brief Blit a sprite to the screen
     /// \param source source sprite
+    /// \param op raster operation
+    ////////////////////////////////////////////////////////////////////////////
+    void blit(const sprite& source, raster_op op = raster_op::copy);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Blit a compiled sprite to the screen
+    /// \param source source sprite
+    /// \param op raster operation
+    ////////////////////////////////////////////////////////////////////////////
+    void blit(const compiled_sprite& source, raster_op op = raster_op::copy);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Blit a frame of an atlas to the screen.
+    /// \param source source atlas
+    /// \param frame source rectangle within the atlas
+    /// \param x x location on screen
+    /// \param y y location on screen
+    /// \param op raster operation
+    ////////////////////////////////////////////////////////////////////////////
+    void blit(const atlas& source, const rect& frame, int x, int y, raster_op op = raster_op::copy);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Blit a named frame of an atlas to the screen.
+    /// \param source source atlas
+    /// \param frame frame name
+    /// \param x x location on screen
+    /// \param y y location on screen
+    /// \param op raster operation
+    ////////////////////////////////////////////////////////////////////////////
+    void blit(const atlas& source, std::string_view frame, int x, int y, raster_op op = raster_op::copy);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Blit a batch of sprites to the screen. Off-screen entries are
+    /// culled and the rest are drawn in z order. The threads started for the
+    /// bands are kept for later batches.
+    /// \param batch sprite batch
+    /// \param bands number of horizontal bands rasterized in parallel
+    ////////////////////////////////////////////////////////////////////////////
+    void blit(const sprite_batch& batch, int bands = 1);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Blit a flipped, scaled and rotated sprite to the screen.
+    /// \param source source sprite
+    /// \param t transform applied to the sprite
+    /// \param op raster operation
     ////////////////////////////////////////////////////////////////////////////
-    void blit(const sprite& source);
+    void blit_ex(const sprite& source, const transform& t, raster_op op = raster_op::copy);
 
     ////////////////////////////////////////////////////////////////////////////
     /// \brief Clear screen.
     /// \param index palette index
+    /// \param op raster operation
+    ////////////////////////////////////////////////////////////////////////////
+    void clear(int index, raster_op op = raster_op::copy);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Cycle a range of the palette, rotating it one entry toward the
+    /// lower index every period. Several ranges may cycle independently.
+    /// \param first first palette index of the range
+    /// \param last last palette index of the range
+    /// \param period time between steps
+    ////////////////////////////////////////////////////////////////////////////
+    void cycle(int first, int last, std::chrono::milliseconds period);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Remove all raster commands.
+    ////////////////////////////////////////////////////////////////////////////
+    void clear_raster();
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Draw a circle outline.
+    /// \param cx x location of the center
+    /// \param cy y location of the center
+    /// \param radius radius in pixels
+    /// \param index palette index
+    /// \param op raster operation
+    ////////////////////////////////////////////////////////////////////////////
+    void draw_circle(int cx, int cy, int radius, int index, raster_op op = raster_op::copy);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Draw an ellipse outline.
+    /// \param cx x location of the center
+    /// \param cy y location of the center
+    /// \param rx horizontal radius in pixels
+    /// \param ry vertical radius in pixels
+    /// \param index palette index
+    /// \param op raster operation
+    ////////////////////////////////////////////////////////////////////////////
+    void draw_ellipse(int cx, int cy, int rx, int ry, int index, raster_op op = raster_op::copy);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Draw a line, including both end points.
+    /// \param x0 x location of start point
+    /// \param y0 y location of start point
+    /// \param x1 x location of end point
+    /// \param y1 y location of end point
+    /// \param index palette index
+    /// \param op raster operation
+    ////////////////////////////////////////////////////////////////////////////
+    void draw_line(int x0, int y0, int x1, int y1, int index, raster_op op = raster_op::copy);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Draw a closed polygon outline.
+    /// \param points vertices (x,y)
+    /// \param index palette index
+    /// \param op raster operation
+    ////////////////////////////////////////////////////////////////////////////
+    void draw_polygon(std::span<const std::pair<int, int>> points, int index, raster_op op = raster_op::copy);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Draw a rectangle outline.
+    /// \param r rectangle
+    /// \param index palette index
+    /// \param op raster operation
+    ////////////////////////////////////////////////////////////////////////////
+    void draw_rect(const rect& r, int index, raster_op op = raster_op::copy);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Fade the palette to a single color.
+    /// \param target target color
+    /// \param duration fade duration
+    ////////////////////////////////////////////////////////////////////////////
+    void fade(const color& target, std::chrono::milliseconds duration);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Fade the palette to another palette.
+    /// \param target target palette
+    /// \param duration fade duration
+    ////////////////////////////////////////////////////////////////////////////
+    void fade(std::span<const color> target, std::chrono::milliseconds duration);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Fade from a single color to a palette.
+    /// \param from starting color
+    /// \param target target palette
+    /// \param duration fade duration
+    ////////////////////////////////////////////////////////////////////////////
+    void fade(const color& from, std::span<const color> target, std::chrono::milliseconds duration);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Test if a palette fade is in progress.
+    /// \return true if fading
+    ////////////////////////////////////////////////////////////////////////////
+    [[nodiscard]] bool fading() const noexcept;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Draw a filled circle.
+    /// \param cx x location of the center
+    /// \param cy y location of the center
+    /// \param radius radius in pixels
+    /// \param index palette index
+    /// \param op raster operation
+    ////////////////////////////////////////////////////////////////////////////
+    void fill_circle(int cx, int cy, int radius, int index, raster_op op = raster_op::copy);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Draw a filled ellipse.
+    /// \param cx x location of the center
+    /// \param cy y location of the center
+    /// \param rx horizontal radius in pixels
+    /// \param ry vertical radius in pixels
+    /// \param index palette index
+    /// \param op raster operation
+    ////////////////////////////////////////////////////////////////////////////
+    void fill_ellipse(int cx, int cy, int rx, int ry, int index, raster_op op = raster_op::copy);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Draw a filled polygon using the even-odd rule. The polygon may
+    /// be concave or self-intersecting.
+    /// \param points vertices (x,y)
+    /// \param index palette index
+    /// \param op raster operation
     ////////////////////////////////////////////////////////////////////////////
-    void clear(int index);
+    void fill_polygon(std::span<const std::pair<int, int>> points, int index, raster_op op = raster_op::copy);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Draw a filled rectangle.
+    /// \param r rectangle
+    /// \param index palette index
+    /// \param op raster operation
+    ////////////////////////////////////////////////////////////////////////////
+    void fill_rect(const rect& r, int index, raster_op op = raster_op::copy);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Fill the 4-connected region of pixels sharing the color of the
+    /// seed pixel.
+    /// \param x x location of the seed pixel
+    /// \param y y location of the seed pixel
+    /// \param index palette index
+    ////////////////////////////////////////////////////////////////////////////
+    void flood_fill(int x, int y, int index);
 
     ////////////////////////////////////////////////////////////////////////////
     /// \brief Get a color from the palette.
@@ -107,6 +363,39 @@ class vga
     ////////////////////////////////////////////////////////////////////////////
     [[nodiscard]] int get_pixel(int x, int y) const;
 
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Get the lines scrolled off the text screen.
+    /// \return scrollback
+    ////////////////////////////////////////////////////////////////////////////
+    [[nodiscard]] const scrollback& get_scrollback() const noexcept;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Get the size of the text screen.
+    /// \return size in character cells (columns, rows)
+    ////////////////////////////////////////////////////////////////////////////
+    [[nodiscard]] std::pair<int, int> get_text_size() const noexcept;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Get the scrollback view offset.
+    /// \return number of lines the view is scrolled back
+    ////////////////////////////////////////////////////////////////////////////
+    [[nodiscard]] int get_view() const noexcept;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Set the palette to an interpolation between two palettes.
+    /// \param from palette at t = 0.0
+    /// \param to palette at t = 1.0
+    /// \param t interpolation factor (0.0-1.0)
+    ////////////////////////////////////////////////////////////////////////////
+    void interpolate_palette(std::span<const color> from, std::span<const color> to, double t);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Move the mouse pointer.
+    /// \param x x location of the hot spot
+    /// \param y y location of the hot spot
+    ////////////////////////////////////////////////////////////////////////////
+    void move_pointer(int x, int y) noexcept;
+
     ////////////////////////////////////////////////////////////////////////////
     /// \brief Print string.
     /// \param s string
@@ -117,6 +406,27 @@ class vga
     ////////////////////////////////////////////////////////////////////////////
     void print(std::string_view s, int col, int row, int fg, bool update_cursor);
 
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Print UTF-8 string. Code points are mapped to glyphs by the
+    /// font; the built-in fonts print them as CP437.
+    /// \param s UTF-8 string
+    /// \param col column
+    /// \param row row
+    /// \param fg foreground color
+    /// \param update_cursor if true, cursor position is updated
+    ////////////////////////////////////////////////////////////////////////////
+    void print(std::u8string_view s, int col, int row, int fg, bool update_cursor);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Draw a glyph in a character cell. The cursor does not move.
+    /// \param col column
+    /// \param row row
+    /// \param index glyph index
+    /// \param fg foreground color
+    /// \param bg background color
+    ////////////////////////////////////////////////////////////////////////////
+    void put_glyph(int col, int row, int index, int fg, int bg);
+
     ////////////////////////////////////////////////////////////////////////////
     /// \brief Write character at cursor position.
     /// \param c character
@@ -124,6 +434,32 @@ class vga
     ////////////////////////////////////////////////////////////////////////////
     void putchar(unsigned char c, int fg);
 
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Change a palette entry from a scanline onward. Raster commands
+    /// are replayed by every call to show() until cleared, and only affect the
+    /// displayed frame, not the palette.
+    /// \param line first scanline affected
+    /// \param index palette index (0-255)
+    /// \param c color
+    ////////////////////////////////////////////////////////////////////////////
+    void raster_color(int line, int index, const color& c);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Pan the display horizontally from a scanline onward. Each line
+    /// wraps around within itself.
+    /// \param line first scanline affected
+    /// \param pixels pan in pixels
+    ////////////////////////////////////////////////////////////////////////////
+    void raster_pan(int line, int pixels);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Change the display start address from a scanline onward. The
+    /// address wraps around the end of VRAM.
+    /// \param line first scanline affected
+    /// \param offset start address in pixels
+    ////////////////////////////////////////////////////////////////////////////
+    void raster_start(int line, int offset);
+
     ////////////////////////////////////////////////////////////////////////////
     /// \brief Reset to the default palette.
     ////////////////////////////////////////////////////////////////////////////
@@ -135,12 +471,46 @@ class vga
     ////////////////////////////////////////////////////////////////////////////
     void scroll_down(int lines = 1);
 
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Scroll a rectangle of the screen down, as INT 10h AH=07h in
+    /// graphics modes. Only the rectangle is redrawn by the next show().
+    /// \param window rectangle to scroll (pixels)
+    /// \param lines number of scanlines to scroll down
+    /// \param fill color index of the scanlines scrolled in
+    ////////////////////////////////////////////////////////////////////////////
+    void scroll_down(const rect& window, int lines, int fill);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Scroll a rectangle of the text screen down, as INT 10h AH=07h.
+    /// \param window rectangle to scroll (character cells)
+    /// \param lines number of text rows to scroll down
+    /// \param bg background color of the rows scrolled in
+    ////////////////////////////////////////////////////////////////////////////
+    void scroll_text_down(const rect& window, int lines, int bg);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Scroll a rectangle of the text screen up, as INT 10h AH=06h.
+    /// \param window rectangle to scroll (character cells)
+    /// \param lines number of text rows to scroll up
+    /// \param bg background color of the rows scrolled in
+    ////////////////////////////////////////////////////////////////////////////
+    void scroll_text_up(const rect& window, int lines, int bg);
+
     ////////////////////////////////////////////////////////////////////////////
     /// \brief Scroll up window.
     /// \param lines number of lines to scroll up
     ////////////////////////////////////////////////////////////////////////////
     void scroll_up(int lines = 1);
 
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Scroll a rectangle of the screen up, as INT 10h AH=06h in
+    /// graphics modes. Only the rectangle is redrawn by the next show().
+    /// \param window rectangle to scroll (pixels)
+    /// \param lines number of scanlines to scroll up
+    /// \param fill color index of the scanlines scrolled in
+    ////////////////////////////////////////////////////////////////////////////
+    void scroll_up(const rect& window, int lines, int fill);
+
     ////////////////////////////////////////////////////////////////////////////
     /// \brief Set an indexed color in the palette.
     /// \param index palette index (0-255)
@@ -150,11 +520,20 @@ class vga
 
     ////////////////////////////////////////////////////////////////////////////
     /// \brief Set cursor position.
-    /// \param col column
-    /// \param row row
+    /// \param col column, wrapped to the screen width
+    /// \param row row, wrapped to the screen height
     ////////////////////////////////////////////////////////////////////////////
     void set_cursor(int col, int row);
 
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Set the shape of the text cursor. The cursor is drawn by show()
+    /// over the converted frame at the cursor position, in the foreground
+    /// color of the character under it, without changing VRAM.
+    /// \param shape cursor shape
+    /// \param blink blink period, or zero for a steady cursor
+    ////////////////////////////////////////////////////////////////////////////
+    void set_cursor_shape(cursor_shape shape, std::chrono::milliseconds blink = std::chrono::milliseconds{229});
+
     ////////////////////////////////////////////////////////////////////////////
     /// \brief Set character font.
     /// \param f character font
@@ -162,7 +541,10 @@ class vga
     void set_font(const font& f);
 
     ////////////////////////////////////////////////////////////////////////////
-    /// \brief Set video mode.
+    /// \brief Set video mode. Each mode keeps its own VRAM, text, palette and
+    /// texture, so switching back to a mode restores its screen contents and
+    /// colors. The font, cursor, scrollback, split screen and palette effects
+    /// are reset on every switch.
     /// \param video_mode standard video mode
     ////////////////////////////////////////////////////////////////////////////
     void set_mode(mode video_mode);
@@ -181,11 +563,96 @@ class vga
     ////////////////////////////////////////////////////////////////////////////
     void set_pixel(int x, int y, int color_index);
 
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Set the image of the mouse pointer. The pointer is drawn by
+    /// show() over the converted frame, without changing VRAM.
+    /// \param image pointer image, using the palette and color key of the
+    /// sprite
+    /// \param hot_x x location of the hot spot within the image
+    /// \param hot_y y location of the hot spot within the image
+    ////////////////////////////////////////////////////////////////////////////
+    void set_pointer(const sprite& image, int hot_x = 0, int hot_y = 0);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Keep the text lines scrolled off the screen, discarding the
+    /// lines kept so far. Only characters are kept, not graphics.
+    /// \param depth maximum number of lines, or 0 to keep none
+    ////////////////////////////////////////////////////////////////////////////
+    void set_scrollback(std::size_t depth);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Set the split line, emulating the VGA line compare register.
+    /// Scanlines from the split line down are displayed from a separate VRAM
+    /// origin and ignore the raster pan and start address.
+    /// \param line first scanline of the lower part, or the screen height to
+    /// disable the split
+    /// \param origin VRAM offset in pixels of the lower part
+    ////////////////////////////////////////////////////////////////////////////
+    void set_split(int line, int origin = 0);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Scroll the view back into the scrollback. While the view is
+    /// scrolled back, show() displays the text of the scrollback and the
+    /// screen in place of VRAM, and the view follows the lines as they scroll
+    /// off.
+    /// \param lines number of lines to scroll back, clamped to the scrollback
+    /// size, or 0 to show VRAM
+    ////////////////////////////////////////////////////////////////////////////
+    void set_view(int lines);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Set vertical sync of the renderer. SDL2 renderers accept only
+    /// vsync on or off, so adaptive sync is requested from SDL but falls back
+    /// to vsync; it takes effect only with an SDL that accepts it, as SDL3
+    /// does, or when the graphics driver is set to adaptive sync for the
+    /// application. Renderers that cannot sync, such as
+    /// the software renderer, ignore the setting; a frame_limiter paces those.
+    /// Until set, the renderer keeps its default.
+    /// \param mode vertical sync mode
+    ////////////////////////////////////////////////////////////////////////////
+    void set_vsync(vsync mode);
+
     ////////////////////////////////////////////////////////////////////////////
     /// \brief Show the screen.
     ////////////////////////////////////////////////////////////////////////////
     void show();
 
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Show or hide the performance overlay. The overlay shows the
+    /// frame rate, frame time, conversion time and bytes uploaded per frame,
+    /// averaged over the last frames. It is drawn by show() over the converted
+    /// frame, without changing VRAM; frames are only timed while it is shown.
+    /// \param visible true to show
+    ////////////////////////////////////////////////////////////////////////////
+    void show_hud(bool visible);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Show or hide the mouse pointer.
+    /// \param visible true to show
+    ////////////////////////////////////////////////////////////////////////////
+    void show_pointer(bool visible) noexcept;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Get the time spent creating the window, renderer and texture,
+    /// including a deferred creation by the first show().
+    /// \return startup time
+    ////////////////////////////////////////////////////////////////////////////
+    [[nodiscard]] std::chrono::microseconds startup_time() const noexcept;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Get the counters of the last frame shown. Counters are only
+    /// recorded when the library is built with RETRO_ENABLE_STATS, and are
+    /// zero otherwise.
+    /// \return frame counters
+    ////////////////////////////////////////////////////////////////////////////
+    [[nodiscard]] frame_stats stats() const noexcept;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Stop all palette fades and cycles. A fade in progress stops at
+    /// its current colors.
+    ////////////////////////////////////////////////////////////////////////////
+    void stop_palette_effects();
+
     vga() = delete;
     vga(const vga&) = delete;
     vga(vga&&) = delete;
@@ -193,6 +660,209 @@ class vga
     vga& operator=(vga&&) = delete;
 
   private:
+    using clock = std::chrono::steady_clock;
+
+    struct palette_cycle
+    {
+        int first{};
+        int last{};
+        clock::duration period{};
+        clock::time_point next;
+    };
+
+    struct palette_fade
+    {
+        std::vector<color> target;
+        clock::time_point start;
+        clock::duration duration{};
+    };
+
+    struct raster_command
+    {
+        enum class type
+        {
+            color,
+            pan,
+            start
+        };
+
+        int line{};
+        type what{type::color};
+        int index{};
+        int value{};
+        std::uint32_t argb{};
+    };
+
+    struct frame_sample
+    {
+        clock::duration frame{};                // time since the previous frame
+        clock::duration convert{};              // time converting VRAM
+        std::size_t upload_bytes{};             // bytes uploaded to the texture
+    };
+
+    struct pointer_image
+    {
+        std::vector<int> pixels;
+        int width{};
+        int height{};
+        int hot_x{};
+        int hot_y{};
+        std::optional<int> key;
+    };
+
+    struct mode_buffers
+    {
+        SDL_Texture* texture{nullptr};
+        std::vector<int> vram;
+        std::vector<std::uint32_t> pixels;
+        std::vector<text_cell> text;
+        std::vector<color> palette;
+    };
+
+    struct fill_span
+    {
+        int x0{};
+        int x1{};
+        int y{};
+        int dy{};
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Blit a rectangle of an indexed image to the screen. VRAM is not
+    /// marked changed, so bands of a batch can be blitted in parallel.
+    /// \param pixels source image
+    /// \param pitch width of the source image
+    /// \param source source rectangle within the image
+    /// \param x x location on screen
+    /// \param y y location on screen
+    /// \param key transparent color key
+    /// \param bounds clipping rectangle
+    /// \param op raster operation
+    /// \return true if any of the rectangle is within the bounds
+    ////////////////////////////////////////////////////////////////////////////
+    bool blit_pixels(std::span<const int> pixels, int pitch, const rect& source, int x, int y,
+                     std::optional<int> key, const rect& bounds, raster_op op);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Add a raster command, keeping commands ordered by scanline.
+    /// \param command raster command
+    ////////////////////////////////////////////////////////////////////////////
+    void add_raster(const raster_command& command);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Create the window and renderer, and the texture of the current
+    /// mode.
+    ////////////////////////////////////////////////////////////////////////////
+    void create_display();
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Create the streaming texture of the current mode.
+    ////////////////////////////////////////////////////////////////////////////
+    void create_texture();
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Convert VRAM to ARGB pixels, replaying the raster commands.
+    ////////////////////////////////////////////////////////////////////////////
+    void convert();
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Add to a frame counter, if counters are recorded.
+    /// \param counter counter
+    /// \param n amount to add
+    ////////////////////////////////////////////////////////////////////////////
+    void count(std::size_t frame_stats::* counter, std::size_t n = 1) noexcept;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Draw a glyph in a character cell.
+    /// \param col column
+    /// \param row row
+    /// \param index glyph index
+    /// \param fg foreground color
+    /// \param bg background color
+    ////////////////////////////////////////////////////////////////////////////
+    void draw_glyph(int col, int row, int index, int fg, int bg);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Draw the performance overlay from the recorded frames.
+    ////////////////////////////////////////////////////////////////////////////
+    void draw_hud();
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Draw the text cursor and mouse pointer over the converted frame,
+    /// and restore the frame where they were shown last.
+    /// \param full_frame true if the whole frame was just uploaded
+    /// \param uploaded true if any part of the frame was just uploaded
+    ////////////////////////////////////////////////////////////////////////////
+    void draw_overlays(bool full_frame, bool uploaded);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Add a changed rectangle of VRAM, for show() to convert and
+    /// upload alone. Too many rectangles fall back to the full frame.
+    /// \param area changed rectangle
+    ////////////////////////////////////////////////////////////////////////////
+    void mark_dirty(const rect& area);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Upload a rectangle of the converted frame with the overlays
+    /// drawn over it.
+    /// \param area rectangle
+    ////////////////////////////////////////////////////////////////////////////
+    void present_overlays(const rect& area);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Print a character at the cursor position and advance the cursor,
+    /// wrapping and scrolling as needed.
+    /// \param c character, for control characters
+    /// \param index glyph index
+    /// \param fg foreground color
+    ////////////////////////////////////////////////////////////////////////////
+    void print_char(char32_t c, int index, int fg);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Draw the text of the scrollback view.
+    ////////////////////////////////////////////////////////////////////////////
+    void render_view();
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Scroll a rectangle of the text screen and its character cells.
+    /// \param window rectangle to scroll (character cells)
+    /// \param lines number of text rows to scroll, up if positive and down if
+    /// negative
+    /// \param bg background color of the rows scrolled in
+    ////////////////////////////////////////////////////////////////////////////
+    void scroll_text_window(const rect& window, int lines, int bg);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Scroll a rectangle of the screen.
+    /// \param window rectangle to scroll (pixels)
+    /// \param lines number of scanlines to scroll, up if positive and down if
+    /// negative
+    /// \param fill color index of the scanlines scrolled in
+    ////////////////////////////////////////////////////////////////////////////
+    void scroll_window(const rect& window, int lines, int fill);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Record the contents of a character cell.
+    /// \param col column
+    /// \param row row
+    /// \param index glyph index
+    /// \param fg foreground color
+    /// \param bg background color
+    ////////////////////////////////////////////////////////////////////////////
+    void set_text(int col, int row, int index, int fg, int bg) noexcept;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Check if the current frame is timed, for the frame counters or
+    /// the performance overlay.
+    /// \return true if timed
+    ////////////////////////////////////////////////////////////////////////////
+    [[nodiscard]] bool timing() const noexcept;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Advance palette effects and rebuild the ARGB lookup table.
+    ////////////////////////////////////////////////////////////////////////////
+    void update_palette();
+
     ////////////////////////////////////////////////////////////////////////////
     /// \brief Convert (x,y) coordinate to linear address.
     /// \param x x location
@@ -218,9 +888,67 @@ class vga
     std::vector<color> m_palette;
     font m_font;
 
+    std::array<std::uint32_t, 256> m_lut{};     // ARGB color of each palette index
+    bool m_lut_dirty{true};                     // lookup table needs a rebuild
+    bool m_palette_dirty{true};                 // lookup table changed since the last frame
+    bool m_vram_dirty{true};                    // VRAM changed since the last frame
+    std::vector<rect> m_dirty_rects;            // VRAM changed within these since the last frame
+
+    std::vector<palette_cycle> m_cycles;
+    std::optional<palette_fade> m_fade;
+
+    std::vector<raster_command> m_raster;
+    int m_split_line{};                         // first line of the split screen
+    int m_split_origin{};                       // VRAM offset of the split screen
+
     std::vector<std::uint32_t> m_pixels;
+
+    std::vector<text_cell> m_text;              // character cells of the text screen
+    scrollback m_scrollback;
+    int m_view{};                               // lines the view is scrolled back
+    std::vector<int> m_view_vram;               // text of the scrollback view
+    std::vector<text_cell> m_view_line;
+
+    cursor_shape m_cursor_shape{cursor_shape::none};
+    clock::duration m_cursor_blink{};
+    clock::time_point m_blink_start;
+    pointer_image m_pointer;
+    int m_pointer_x{};
+    int m_pointer_y{};
+    bool m_pointer_visible{false};
+    bool m_pointer_changed{false};              // image, hot spot or visibility set since the last frame
+    std::array<std::optional<rect>, 3> m_overlays;  // cursor, HUD and pointer as last shown
+    std::vector<std::uint32_t> m_overlay_pixels;
+
+    bool m_hud_visible{false};
+    std::vector<std::uint32_t> m_hud_pixels;
+    std::array<frame_sample, 60> m_samples{};   // ring of the last frames
+    std::size_t m_num_samples{};
+    std::size_t m_next_sample{};
+    frame_stats m_counters;                     // frame being recorded
+    frame_stats m_stats;                        // last frame shown
+    std::size_t m_allocations{};                // allocation count at the last frame
+    clock::time_point m_last_frame;
+
+    std::optional<vsync> m_vsync;
+
+    clock::duration m_startup{};                // time spent creating SDL resources
+
+    std::optional<mode> m_mode;
+    std::map<mode, mode_buffers> m_mode_cache;  // buffers of the inactive modes
+
+    std::vector<std::size_t> m_batch_order;
+    std::unique_ptr<detail::worker_pool> m_workers;  // threads rasterizing batch bands
+    std::vector<fill_span> m_fill_stack;
 };
 
+
+////////////////////////////////////////////////////////////////////////////////
+constexpr std::size_t vga::xy_to_index(const int x, const int y) const noexcept
+{
+    return static_cast<std::size_t>(x + m_width * y);
+}
+
 }   // retro
 
 
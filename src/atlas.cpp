@@ -0,0 +1,107 @@
+////////////////////////////////////////////////////////////////////////////////
+// Retro - Retro Computing Library
+// Copyright (c) 2023 Ryan Clarke
+////////////////////////////////////////////////////////////////////////////////
+
+#include "retro/atlas.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+
+////////////////////////////////////////////////////////////////////////////////
+namespace retro
+{
+
+////////////////////////////////////////////////////////////////////////////////
+atlas::atlas(const int width, const int height, const std::optional<std::span<const int>>& pixels)
+    : m_width{width}, m_height{height}
+{
+    if(width < 1 || height < 1)
+    {
+        throw std::invalid_argument("atlas ctor has an invalid argument");
+    }
+
+    m_texture.resize(static_cast<std::size_t>(width * height));
+
+    if(pixels.has_value())
+    {
+        const auto p = pixels.value();
+
+        if(p.size() != m_texture.size())
+        {
+            throw std::invalid_argument("atlas ctor has an invalid argument");
+        }
+
+        std::ranges::copy(p, m_texture.begin());
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void atlas::add_frame(std::string name, const rect& frame)
+{
+    if(frame.x < 0 || frame.y < 0 || frame.width < 1 || frame.height < 1 ||
+       frame.x + frame.width > m_width || frame.y + frame.height > m_height)
+    {
+        throw std::invalid_argument("atlas::add_frame has an invalid argument");
+    }
+
+    m_frames.insert_or_assign(std::move(name), frame);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void atlas::color_key(const std::optional<int> key)
+{
+    if(key.has_value() && (key.value() < 0 || key.value() > 255))
+    {
+        throw std::invalid_argument("atlas::color_key has an invalid argument");
+    }
+
+    m_color_key = key;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+std::optional<int> atlas::color_key() const noexcept
+{
+    return m_color_key;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+rect atlas::frame(const std::string_view name) const
+{
+    const auto it = m_frames.find(name);
+
+    if(it == m_frames.end())
+    {
+        throw std::invalid_argument("atlas::frame has an invalid argument");
+    }
+
+    return it->second;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+const std::vector<int>& atlas::pixels() const noexcept
+{
+    return m_texture;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+std::pair<int, int> atlas::size() const noexcept
+{
+    return {m_width, m_height};
+}
+
+}   // retro
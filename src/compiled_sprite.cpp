@@ -0,0 +1,125 @@
+////////////////////////////////////////////////////////////////////////////////
+// Retro - Retro Computing Library
+// Copyright (c) 2023 Ryan Clarke
+////////////////////////////////////////////////////////////////////////////////
+
+#include "retro/compiled_sprite.hpp"
+#include "retro/sprite.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+
+////////////////////////////////////////////////////////////////////////////////
+namespace retro
+{
+
+////////////////////////////////////////////////////////////////////////////////
+compiled_sprite::compiled_sprite(const sprite& source)
+{
+    std::tie(m_width, m_height) = source.size();
+    std::tie(m_x, m_y) = source.position();
+
+    const auto& pixels = source.pixels();
+
+    if(std::ssize(pixels) < m_width * m_height)
+    {
+        throw std::invalid_argument("compiled_sprite ctor has an invalid argument");
+    }
+
+    const auto key = source.color_key();
+    const auto opaque = [=](const int p) { return !key.has_value() || p != key.value(); };
+
+    m_rows.reserve(static_cast<std::size_t>(m_height) + 1);
+
+    for(const auto y : std::views::iota(0, m_height))
+    {
+        m_rows.emplace_back(m_runs.size());
+
+        const auto row = std::span{pixels}.subspan(static_cast<std::size_t>(y * m_width),
+                                                   static_cast<std::size_t>(m_width));
+        auto first = row.begin();
+
+        while(first != row.end())
+        {
+            const auto start = std::find_if(first, row.end(), opaque);
+
+            if(start == row.end())
+            {
+                break;
+            }
+
+            const auto end = std::find_if_not(start, row.end(), opaque);
+
+            m_runs.push_back({static_cast<int>(start - first),
+                              static_cast<int>(end - start),
+                              m_pixels.size()});
+            std::copy(start, end, std::back_inserter(m_pixels));
+
+            first = end;
+        }
+    }
+
+    m_rows.emplace_back(m_runs.size());
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void compiled_sprite::move(const int dx, const int dy) noexcept
+{
+    m_x += dx;
+    m_y += dy;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+std::span<const int> compiled_sprite::pixels() const noexcept
+{
+    return m_pixels;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void compiled_sprite::position(const int x, const int y) noexcept
+{
+    m_x = x;
+    m_y = y;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+std::pair<int, int> compiled_sprite::position() const noexcept
+{
+    return {m_x, m_y};
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+std::span<const compiled_sprite::run> compiled_sprite::runs(const int row) const
+{
+    if(row < 0 || row >= m_height)
+    {
+        throw std::invalid_argument("compiled_sprite::runs has an invalid argument");
+    }
+
+    const auto first = m_rows[static_cast<std::size_t>(row)];
+    const auto last = m_rows[static_cast<std::size_t>(row) + 1];
+
+    return std::span{m_runs}.subspan(first, last - first);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+std::pair<int, int> compiled_sprite::size() const noexcept
+{
+    return {m_width, m_height};
+}
+
+}   // retro
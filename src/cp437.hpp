@@ -0,0 +1,92 @@
+////////////////////////////////////////////////////////////////////////////////
+// Retro - Retro Computing Library
+// Copyright (c) 2023 Ryan Clarke
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef RETRO_CP437_HPP
+#define RETRO_CP437_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <optional>
+
+
+////////////////////////////////////////////////////////////////////////////////
+namespace retro::detail
+{
+
+////////////////////////////////////////////////////////////////////////////////
+struct cp437_entry
+{
+    char32_t code_point{};
+    std::uint8_t index{};
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// \brief Code points of the CP437 glyphs outside printable ASCII, sorted by
+/// code point: the symbols shown for 01h-1Fh and 7Fh, and the upper half.
+////////////////////////////////////////////////////////////////////////////////
+inline constexpr std::array<cp437_entry, 160> cp437
+{{
+    {U'\x00a0', 0xff}, {U'\x00a1', 0xad}, {U'\x00a2', 0x9b}, {U'\x00a3', 0x9c}, {U'\x00a5', 0x9d}, {U'\x00a7', 0x15},
+    {U'\x00aa', 0xa6}, {U'\x00ab', 0xae}, {U'\x00ac', 0xaa}, {U'\x00b0', 0xf8}, {U'\x00b1', 0xf1}, {U'\x00b2', 0xfd},
+    {U'\x00b5', 0xe6}, {U'\x00b6', 0x14}, {U'\x00b7', 0xfa}, {U'\x00ba', 0xa7}, {U'\x00bb', 0xaf}, {U'\x00bc', 0xac},
+    {U'\x00bd', 0xab}, {U'\x00bf', 0xa8}, {U'\x00c4', 0x8e}, {U'\x00c5', 0x8f}, {U'\x00c6', 0x92}, {U'\x00c7', 0x80},
+    {U'\x00c9', 0x90}, {U'\x00d1', 0xa5}, {U'\x00d6', 0x99}, {U'\x00dc', 0x9a}, {U'\x00df', 0xe1}, {U'\x00e0', 0x85},
+    {U'\x00e1', 0xa0}, {U'\x00e2', 0x83}, {U'\x00e4', 0x84}, {U'\x00e5', 0x86}, {U'\x00e6', 0x91}, {U'\x00e7', 0x87},
+    {U'\x00e8', 0x8a}, {U'\x00e9', 0x82}, {U'\x00ea', 0x88}, {U'\x00eb', 0x89}, {U'\x00ec', 0x8d}, {U'\x00ed', 0xa1},
+    {U'\x00ee', 0x8c}, {U'\x00ef', 0x8b}, {U'\x00f1', 0xa4}, {U'\x00f2', 0x95}, {U'\x00f3', 0xa2}, {U'\x00f4', 0x93},
+    {U'\x00f6', 0x94}, {U'\x00f7', 0xf6}, {U'\x00f9', 0x97}, {U'\x00fa', 0xa3}, {U'\x00fb', 0x96}, {U'\x00fc', 0x81},
+    {U'\x00ff', 0x98}, {U'\x0192', 0x9f}, {U'\x0393', 0xe2}, {U'\x0398', 0xe9}, {U'\x03a3', 0xe4}, {U'\x03a6', 0xe8},
+    {U'\x03a9', 0xea}, {U'\x03b1', 0xe0}, {U'\x03b4', 0xeb}, {U'\x03b5', 0xee}, {U'\x03c0', 0xe3}, {U'\x03c3', 0xe5},
+    {U'\x03c4', 0xe7}, {U'\x03c6', 0xed}, {U'\x2022', 0x07}, {U'\x203c', 0x13}, {U'\x207f', 0xfc}, {U'\x20a7', 0x9e},
+    {U'\x2190', 0x1b}, {U'\x2191', 0x18}, {U'\x2192', 0x1a}, {U'\x2193', 0x19}, {U'\x2194', 0x1d}, {U'\x2195', 0x12},
+    {U'\x21a8', 0x17}, {U'\x2219', 0xf9}, {U'\x221a', 0xfb}, {U'\x221e', 0xec}, {U'\x221f', 0x1c}, {U'\x2229', 0xef},
+    {U'\x2248', 0xf7}, {U'\x2261', 0xf0}, {U'\x2264', 0xf3}, {U'\x2265', 0xf2}, {U'\x2302', 0x7f}, {U'\x2310', 0xa9},
+    {U'\x2320', 0xf4}, {U'\x2321', 0xf5}, {U'\x2500', 0xc4}, {U'\x2502', 0xb3}, {U'\x250c', 0xda}, {U'\x2510', 0xbf},
+    {U'\x2514', 0xc0}, {U'\x2518', 0xd9}, {U'\x251c', 0xc3}, {U'\x2524', 0xb4}, {U'\x252c', 0xc2}, {U'\x2534', 0xc1},
+    {U'\x253c', 0xc5}, {U'\x2550', 0xcd}, {U'\x2551', 0xba}, {U'\x2552', 0xd5}, {U'\x2553', 0xd6}, {U'\x2554', 0xc9},
+    {U'\x2555', 0xb8}, {U'\x2556', 0xb7}, {U'\x2557', 0xbb}, {U'\x2558', 0xd4}, {U'\x2559', 0xd3}, {U'\x255a', 0xc8},
+    {U'\x255b', 0xbe}, {U'\x255c', 0xbd}, {U'\x255d', 0xbc}, {U'\x255e', 0xc6}, {U'\x255f', 0xc7}, {U'\x2560', 0xcc},
+    {U'\x2561', 0xb5}, {U'\x2562', 0xb6}, {U'\x2563', 0xb9}, {U'\x2564', 0xd1}, {U'\x2565', 0xd2}, {U'\x2566', 0xcb},
+    {U'\x2567', 0xcf}, {U'\x2568', 0xd0}, {U'\x2569', 0xca}, {U'\x256a', 0xd8}, {U'\x256b', 0xd7}, {U'\x256c', 0xce},
+    {U'\x2580', 0xdf}, {U'\x2584', 0xdc}, {U'\x2588', 0xdb}, {U'\x258c', 0xdd}, {U'\x2590', 0xde}, {U'\x2591', 0xb0},
+    {U'\x2592', 0xb1}, {U'\x2593', 0xb2}, {U'\x25a0', 0xfe}, {U'\x25ac', 0x16}, {U'\x25b2', 0x1e}, {U'\x25ba', 0x10},
+    {U'\x25bc', 0x1f}, {U'\x25c4', 0x11}, {U'\x25cb', 0x09}, {U'\x25d8', 0x08}, {U'\x25d9', 0x0a}, {U'\x263a', 0x01},
+    {U'\x263b', 0x02}, {U'\x263c', 0x0f}, {U'\x2640', 0x0c}, {U'\x2642', 0x0b}, {U'\x2660', 0x06}, {U'\x2663', 0x05},
+    {U'\x2665', 0x03}, {U'\x2666', 0x04}, {U'\x266a', 0x0d}, {U'\x266b', 0x0e}
+}};
+
+static_assert(std::ranges::is_sorted(cp437, {}, &cp437_entry::code_point));
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// \brief Find the CP437 glyph of a code point. ASCII maps to itself.
+/// \param c code point
+/// \return glyph index, or nothing if CP437 has no such glyph
+////////////////////////////////////////////////////////////////////////////////
+[[nodiscard]] constexpr std::optional<int> to_cp437(const char32_t c) noexcept
+{
+    if(c < 0x80)
+    {
+        return static_cast<int>(c);
+    }
+
+    const auto it = std::ranges::lower_bound(cp437, c, {}, &cp437_entry::code_point);
+
+    if(it == cp437.end() || it->code_point != c)
+    {
+        return std::nullopt;
+    }
+
+    return it->index;
+}
+
+static_assert(to_cp437(U'\x2588') == 0xdb);
+
+}   // retro::detail
+
+
+#endif  // RETRO_CP437_HPP
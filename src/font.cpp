@@ -5,10 +5,13 @@
 
 #include "retro/font.hpp"
 
+#include "cp437.hpp"
+
 #include <algorithm>
 #include <cstddef>
 #include <cstdint>
-#include <iterator>
+#include <memory>
+#include <optional>
 #include <ranges>
 #include <span>
 #include <stdexcept>
@@ -21,41 +24,73 @@ namespace retro
 {
 
 ////////////////////////////////////////////////////////////////////////////////
-font::font(const std::span<const std::byte> glyphs, const int width, const int height)
-    : m_width{width}, m_height{height}
+font::font(const std::span<const std::byte> glyphs, const int width, const int height, const int spacing)
+    : font{std::vector<std::byte>(glyphs.begin(), glyphs.end()), width, height, spacing}
+{
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+font::font(std::vector<std::byte> glyphs, const int width, const int height, const int spacing)
+    : font{glyphs, width, height, spacing, 0}
 {
-    if(width < 8 || height < 1 || (std::ssize(glyphs) / height) > 256)
+    // widths above 8 once meant 8 pixel rows and a blank column; a table no
+    // larger than the 256 one byte glyphs of those fonts is rejected rather
+    // than read with wider rows
+    if(width > 8 && spacing == 0 && glyphs.size() <= 256 * static_cast<std::size_t>(height))
     {
         throw std::invalid_argument("font ctor has an invalid argument");
     }
 
-    std::ranges::copy(glyphs, std::back_inserter(m_glyphs));
+    // the span viewed the argument; view the shared copy instead
+    auto storage = std::make_shared<const std::vector<std::byte>>(std::move(glyphs));
+    m_glyphs = *storage;
+    m_owner = std::move(storage);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+font::font(const std::span<const std::byte> glyphs, std::shared_ptr<const void> owner, const int width,
+           const int height, const int spacing, const std::size_t glyph_size)
+    : font{glyphs, width, height, spacing, glyph_size}
+{
+    m_owner = std::move(owner);
 }
 
 
 ////////////////////////////////////////////////////////////////////////////////
-std::vector<int> font::glyph(const unsigned char c, const int fg, const int bg) const
+std::vector<int> font::glyph(const int index, const int fg, const int bg) const
 {
-    if(fg < 0 || fg > 255 || bg < 0 || bg > 255)
+    if(index < 0 || fg < 0 || fg > 255 || bg < 0 || bg > 255)
     {
         throw std::invalid_argument("font::glyph has an invalid argument");
     }
 
-    const auto glyph = m_glyphs | std::views::drop(m_height * c) | std::views::take(m_height);
-    std::vector<int> color_glyph;
+    const auto [width, height] = size();
+    std::vector<int> color_glyph(static_cast<std::size_t>(width * height), bg);
+
+    const auto glyph = rows(index);
+    const auto stride = static_cast<std::size_t>(m_stride);
+    auto dst = color_glyph.begin();
 
     // construct a colorized glyph with the passed foreground and background colors
-    for(auto line : glyph)
+    for(std::size_t first = 0; first < glyph.size(); first += stride, dst += width)
     {
-        std::for_each_n(std::back_inserter(color_glyph), 8, [=, &line](auto& color)
+        auto line = std::uint32_t{0};
+
+        for(const auto b : glyph.subspan(first, stride))
         {
-            color = ((std::to_integer<std::uint8_t>(line) & 0x80u) == 0u) ? bg : fg;
-            line <<= 1;
-        });
+            line = (line << 8) | std::to_integer<std::uint32_t>(b);
+        }
 
-        if(m_width == 9)
+        const auto msb = std::uint32_t{1} << (m_stride * 8 - 1);
+
+        for(const auto x : std::views::iota(0, m_width))
         {
-            color_glyph.emplace_back(bg);
+            if((line & (msb >> x)) != 0u)
+            {
+                dst[x] = fg;
+            }
         }
     }
 
@@ -64,9 +99,42 @@ std::vector<int> font::glyph(const unsigned char c, const int fg, const int bg)
 
 
 ////////////////////////////////////////////////////////////////////////////////
-std::pair<int, int> font::size() const noexcept
+int font::index(const char32_t c) const noexcept
+{
+    const auto find = [this](const char32_t code_point) -> std::optional<int>
+    {
+        if(!m_unicode)
+        {
+            return detail::to_cp437(code_point);
+        }
+
+        if(m_unicode_map == nullptr)
+        {
+            return (code_point < static_cast<char32_t>(count())) ? std::optional{static_cast<int>(code_point)}
+                                                                : std::nullopt;
+        }
+
+        const auto it = std::ranges::lower_bound(*m_unicode_map, code_point, {},
+                                                 &std::pair<char32_t, int>::first);
+
+        return (it != m_unicode_map->end() && it->first == code_point) ? std::optional{it->second}
+                                                                       : std::nullopt;
+    };
+
+    return find(c).or_else([&] { return find(U'?'); }).value_or(0);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+std::span<const std::byte> font::rows(const int index) const noexcept
 {
-    return {m_width, m_height};
+    if(index < 0 || index >= count())
+    {
+        return {};
+    }
+
+    return m_glyphs.subspan(static_cast<std::size_t>(index) * m_glyph_size,
+                            static_cast<std::size_t>(m_stride * m_height));
 }
 
 }   // retro
@@ -0,0 +1,516 @@
+////////////////////////////////////////////////////////////////////////////////
+// Retro - Retro Computing Library
+// Copyright (c) 2023 Ryan Clarke
+////////////////////////////////////////////////////////////////////////////////
+
+#include "retro/font.hpp"
+
+#include "utf8.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+
+////////////////////////////////////////////////////////////////////////////////
+namespace
+{
+
+////////////////////////////////////////////////////////////////////////////////
+/// \brief Read-only memory mapping of a whole file.
+////////////////////////////////////////////////////////////////////////////////
+class mapped_file
+{
+  public:
+    explicit mapped_file(const std::filesystem::path& path)
+    {
+        const auto fd = ::open(path.c_str(), O_RDONLY);
+
+        if(fd == -1)
+        {
+            throw std::system_error(errno, std::generic_category(), path.string());
+        }
+
+        struct stat st{};
+
+        if(::fstat(fd, &st) == -1)
+        {
+            const auto error = errno;
+            ::close(fd);
+            throw std::system_error(error, std::generic_category(), path.string());
+        }
+
+        m_size = static_cast<std::size_t>(st.st_size);
+
+        if(m_size != 0)
+        {
+            m_data = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        }
+
+        const auto error = errno;
+        ::close(fd);
+
+        if(m_data == MAP_FAILED)
+        {
+            throw std::system_error(error, std::generic_category(), path.string());
+        }
+    }
+
+    ~mapped_file()
+    {
+        if(m_data != nullptr && m_data != MAP_FAILED)
+        {
+            ::munmap(m_data, m_size);
+        }
+    }
+
+    mapped_file(const mapped_file&) = delete;
+    mapped_file& operator=(const mapped_file&) = delete;
+
+    [[nodiscard]] std::span<const std::byte> bytes() const noexcept
+    {
+        return {static_cast<const std::byte*>(m_data), (m_data == nullptr) ? 0 : m_size};
+    }
+
+  private:
+    void* m_data{nullptr};
+    std::size_t m_size{};
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// \brief Read a little-endian 32 bit value.
+/// \param bytes source bytes, at least 4
+/// \return value
+////////////////////////////////////////////////////////////////////////////////
+[[nodiscard]] std::uint32_t read_le32(const std::span<const std::byte> bytes) noexcept
+{
+    return std::to_integer<std::uint32_t>(bytes[0]) |
+           (std::to_integer<std::uint32_t>(bytes[1]) << 8) |
+           (std::to_integer<std::uint32_t>(bytes[2]) << 16) |
+           (std::to_integer<std::uint32_t>(bytes[3]) << 24);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// \brief Split the next whitespace separated word off a line.
+/// \param line line, advanced past the word
+/// \return word, empty at the end of the line
+////////////////////////////////////////////////////////////////////////////////
+[[nodiscard]] std::string_view next_word(std::string_view& line) noexcept
+{
+    const auto first = line.find_first_not_of(" \t\r");
+
+    if(first == std::string_view::npos)
+    {
+        line = {};
+        return {};
+    }
+
+    line.remove_prefix(first);
+    const auto last = std::min(line.find_first_of(" \t\r"), line.size());
+    const auto word = line.substr(0, last);
+    line.remove_prefix(last);
+
+    return word;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// \brief Parse the numbers following a keyword.
+/// \param line rest of the line
+/// \param base number base
+/// \return values, or nothing if a value is missing or malformed
+////////////////////////////////////////////////////////////////////////////////
+template<typename T, std::size_t N>
+[[nodiscard]] std::optional<std::array<T, N>> parse_numbers(std::string_view line, const int base = 10)
+{
+    std::array<T, N> values{};
+
+    for(auto& v : values)
+    {
+        const auto word = next_word(line);
+        const auto [end, error] = std::from_chars(word.data(), word.data() + word.size(), v, base);
+
+        if(word.empty() || error != std::errc{} || end != word.data() + word.size())
+        {
+            return std::nullopt;
+        }
+    }
+
+    return values;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+using unicode_map = std::vector<std::pair<char32_t, int>>;
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// \brief Parse a PSF1 Unicode table: for each glyph, 16 bit code points
+/// ended by FFFFh, with FFFEh starting sequences, which are skipped.
+/// \param table table bytes
+/// \param count number of glyphs
+/// \return code points and glyphs, sorted by code point
+////////////////////////////////////////////////////////////////////////////////
+[[nodiscard]] unicode_map psf1_unicode(const std::span<const std::byte> table, const int count)
+{
+    unicode_map map;
+    auto glyph = 0;
+    auto sequence = false;
+
+    for(std::size_t i = 0; i + 1 < table.size() && glyph < count; i += 2)
+    {
+        const auto c = std::to_integer<char32_t>(table[i]) | (std::to_integer<char32_t>(table[i + 1]) << 8);
+
+        if(c == 0xffff)
+        {
+            ++glyph;
+            sequence = false;
+        }
+        else if(c == 0xfffe)
+        {
+            sequence = true;
+        }
+        else if(!sequence)
+        {
+            map.emplace_back(c, glyph);
+        }
+    }
+
+    std::ranges::stable_sort(map, {}, &std::pair<char32_t, int>::first);
+    return map;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// \brief Parse a PSF2 Unicode table: for each glyph, UTF-8 code points ended
+/// by FFh, with FEh starting sequences, which are skipped.
+/// \param table table bytes
+/// \param count number of glyphs
+/// \return code points and glyphs, sorted by code point
+////////////////////////////////////////////////////////////////////////////////
+[[nodiscard]] unicode_map psf2_unicode(const std::span<const std::byte> table, const int count)
+{
+    const std::u8string_view text{reinterpret_cast<const char8_t*>(table.data()), table.size()};
+
+    unicode_map map;
+    auto glyph = 0;
+    auto sequence = false;
+
+    for(std::size_t i = 0; i < text.size() && glyph < count;)
+    {
+        if(text[i] == 0xff)
+        {
+            ++glyph;
+            sequence = false;
+            ++i;
+        }
+        else if(text[i] == 0xfe)
+        {
+            sequence = true;
+            ++i;
+        }
+        else
+        {
+            const auto [c, length] = retro::detail::decode(text.substr(i));
+
+            if(!sequence && c != retro::detail::replacement_character)
+            {
+                map.emplace_back(c, glyph);
+            }
+
+            i += length;
+        }
+    }
+
+    std::ranges::stable_sort(map, {}, &std::pair<char32_t, int>::first);
+    return map;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+constexpr std::size_t max_bdf_size{16 * 1024 * 1024};   // glyph bytes of a BDF font
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// \brief Check that the height and offsets of a BDF bounding box are in a
+/// range that glyph rows can be placed from without overflow.
+/// \param box bounding box (width, height, x offset, y offset)
+/// \return true if valid
+////////////////////////////////////////////////////////////////////////////////
+constexpr bool valid_bdf_coordinates(const std::array<int, 4>& box) noexcept
+{
+    constexpr int limit{0xffff};
+
+    return box[1] >= 0 && box[1] <= limit && box[2] >= -limit && box[2] <= limit &&
+           box[3] >= -limit && box[3] <= limit;
+}
+
+}   // unnamed
+
+
+////////////////////////////////////////////////////////////////////////////////
+namespace retro
+{
+
+////////////////////////////////////////////////////////////////////////////////
+font font::load_bdf(const std::filesystem::path& path)
+{
+    const mapped_file file{path};
+    const auto bytes = file.bytes();
+    std::string_view text{reinterpret_cast<const char*>(bytes.data()), bytes.size()};
+
+    const auto invalid = [&] { return std::runtime_error("font::load_bdf cannot parse " + path.string()); };
+
+    std::optional<std::array<int, 4>> bounds;       // font bounding box (w, h, x, y)
+    std::array<int, 4> bbx{};                       // glyph bounding box (w, h, x, y)
+    auto encoding = -1;
+    auto bitmap_row = -1;                           // row of the bitmap being read, -1 outside
+    std::vector<std::byte> glyphs;
+
+    while(!text.empty())
+    {
+        const auto eol = std::min(text.find('\n'), text.size());
+        auto line = text.substr(0, eol);
+        text.remove_prefix(std::min(eol + 1, text.size()));
+
+        const auto keyword = next_word(line);
+
+        if(keyword == "FONTBOUNDINGBOX")
+        {
+            bounds = parse_numbers<int, 4>(line);
+
+            if(!bounds.has_value() || (*bounds)[0] < 1 || (*bounds)[0] > 32 || (*bounds)[1] < 1 ||
+               !valid_bdf_coordinates(*bounds))
+            {
+                throw invalid();
+            }
+
+            continue;
+        }
+
+        if(keyword.empty() || !bounds.has_value())
+        {
+            continue;
+        }
+
+        const auto [font_w, font_h, font_x, font_y] = *bounds;
+        const auto stride = (font_w + 7) / 8;
+        const auto glyph_size = static_cast<std::size_t>(stride * font_h);
+
+        if(keyword == "ENDCHAR")
+        {
+            bitmap_row = -1;
+            encoding = -1;
+        }
+        else if(bitmap_row >= 0)
+        {
+            const auto bits = parse_numbers<std::uint32_t, 1>(keyword, 16);
+            const auto row = font_y + font_h - bbx[3] - bbx[1] + bitmap_row++;
+
+            if(!bits.has_value())
+            {
+                throw invalid();
+            }
+
+            if(encoding < 0 || row < 0 || row >= font_h)
+            {
+                continue;
+            }
+
+            // move the row from the glyph box to the font cell, leftmost pixel
+            // in the most significant bit of the row; a row shifted by the
+            // whole width is outside the cell
+            const auto shift = ((bbx[0] + 7) / 8) * 8 - stride * 8 + (bbx[2] - font_x);
+            auto line_bits = std::uint64_t{(*bits)[0]};
+
+            if(shift >= 64 || shift <= -64)
+            {
+                line_bits = 0;
+            }
+            else
+            {
+                line_bits = (shift >= 0) ? (line_bits >> shift) : (line_bits << -shift);
+            }
+
+            const auto first = static_cast<std::size_t>(encoding) * glyph_size +
+                               static_cast<std::size_t>(row * stride);
+
+            for(const auto i : std::views::iota(0, stride))
+            {
+                glyphs[first + static_cast<std::size_t>(i)] |=
+                    std::byte(static_cast<std::uint8_t>(line_bits >> ((stride - 1 - i) * 8)));
+            }
+        }
+        else if(keyword == "ENCODING")
+        {
+            const auto value = parse_numbers<int, 1>(line);
+
+            if(!value.has_value())
+            {
+                throw invalid();
+            }
+
+            // glyphs without a standard encoding, or beyond the BMP, are skipped
+            encoding = ((*value)[0] >= 0 && (*value)[0] <= 0xffff) ? (*value)[0] : -1;
+
+            if(encoding >= 0)
+            {
+                const auto size = (static_cast<std::size_t>(encoding) + 1) * glyph_size;
+
+                if(size > max_bdf_size)
+                {
+                    throw invalid();
+                }
+
+                glyphs.resize(std::max(glyphs.size(), size));
+            }
+        }
+        else if(keyword == "BBX")
+        {
+            const auto value = parse_numbers<int, 4>(line);
+
+            if(!value.has_value() || (*value)[0] < 0 || (*value)[0] > 32 || !valid_bdf_coordinates(*value))
+            {
+                throw invalid();
+            }
+
+            bbx = *value;
+        }
+        else if(keyword == "BITMAP")
+        {
+            bitmap_row = 0;
+        }
+    }
+
+    if(!bounds.has_value())
+    {
+        throw invalid();
+    }
+
+    // BDF fonts of any width and glyph count are valid, so the glyphs are
+    // shared directly rather than through the public ctor
+    const auto storage = std::make_shared<const std::vector<std::byte>>(std::move(glyphs));
+    font f{*storage, storage, (*bounds)[0], (*bounds)[1], 0, 0};
+    f.m_unicode = true;
+
+    return f;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+font font::load_psf(const std::filesystem::path& path)
+{
+    auto file = std::make_shared<const mapped_file>(path);
+    const auto bytes = file->bytes();
+
+    const auto invalid = [&] { return std::runtime_error("font::load_psf cannot parse " + path.string()); };
+
+    constexpr std::array psf1_magic{std::byte{0x36}, std::byte{0x04}};
+    constexpr std::array psf2_magic{std::byte{0x72}, std::byte{0xb5}, std::byte{0x4a}, std::byte{0x86}};
+
+    if(bytes.size() >= 4 && std::ranges::equal(bytes.first(2), psf1_magic))
+    {
+        // PSF1: 8 pixels wide, 256 glyphs, or 512 with the 512 glyph mode bit
+        const auto mode = std::to_integer<unsigned>(bytes[2]);
+        const auto height = std::to_integer<int>(bytes[3]);
+        const auto count = ((mode & 0x01u) != 0u) ? std::size_t{512} : std::size_t{256};
+        const auto size = count * static_cast<std::size_t>(height);
+
+        if(height == 0 || bytes.size() < 4 + size)
+        {
+            throw invalid();
+        }
+
+        font f{bytes.subspan(4, size), std::move(file), 8, height, 0, 0};
+
+        // the Unicode table and sequence mode bits
+        if((mode & 0x06u) != 0u)
+        {
+            f.m_unicode = true;
+            f.m_unicode_map = std::make_shared<const unicode_map>(
+                psf1_unicode(bytes.subspan(4 + size), static_cast<int>(count)));
+        }
+
+        return f;
+    }
+
+    if(bytes.size() >= 32 && std::ranges::equal(bytes.first(4), psf2_magic))
+    {
+        const auto header_size = read_le32(bytes.subspan(8));
+        const auto count = read_le32(bytes.subspan(16));
+        const auto glyph_size = read_le32(bytes.subspan(20));
+        const auto height = read_le32(bytes.subspan(24));
+        const auto width = read_le32(bytes.subspan(28));
+
+        // sizes are checked in 64 bits so that no product of header values
+        // wraps; the height has the same limit as BDF coordinates
+        const auto min_glyph_size = std::uint64_t{height} * ((width + 7) / 8);
+
+        if(width < 1 || width > 32 || height < 1 || height > 0xffff || glyph_size == 0 ||
+           glyph_size < min_glyph_size || header_size > bytes.size() ||
+           std::uint64_t{count} * glyph_size > bytes.size() - header_size)
+        {
+            throw invalid();
+        }
+
+        const auto size = std::size_t{count} * glyph_size;
+        const auto flags = read_le32(bytes.subspan(12));
+
+        font f{bytes.subspan(header_size, size), std::move(file), static_cast<int>(width),
+               static_cast<int>(height), 0, glyph_size};
+
+        // the Unicode table flag
+        if((flags & 0x01u) != 0u)
+        {
+            f.m_unicode = true;
+            f.m_unicode_map = std::make_shared<const unicode_map>(
+                psf2_unicode(bytes.subspan(header_size + size), static_cast<int>(count)));
+        }
+
+        return f;
+    }
+
+    throw invalid();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+font font::load_raw(const std::filesystem::path& path, const int height)
+{
+    if(height < 1)
+    {
+        throw std::invalid_argument("font::load_raw has an invalid argument");
+    }
+
+    auto file = std::make_shared<const mapped_file>(path);
+    const auto bytes = file->bytes();
+
+    if(bytes.empty() || bytes.size() % static_cast<std::size_t>(height) != 0)
+    {
+        throw std::runtime_error("font::load_raw cannot parse " + path.string());
+    }
+
+    return font{bytes, std::move(file), 8, height, 0, 0};
+}
+
+}   // retro
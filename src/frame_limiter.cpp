@@ -0,0 +1,146 @@
+////////////////////////////////////////////////////////////////////////////////
+// Retro - Retro Computing Library
+// Copyright (c) 2023 Ryan Clarke
+////////////////////////////////////////////////////////////////////////////////
+
+#include "retro/frame_limiter.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <span>
+#include <stdexcept>
+#include <thread>
+
+
+////////////////////////////////////////////////////////////////////////////////
+namespace
+{
+
+////////////////////////////////////////////////////////////////////////////////
+constexpr std::chrono::microseconds min_margin{250};
+constexpr std::chrono::microseconds max_margin{4000};
+constexpr std::chrono::microseconds initial_margin{1000};
+
+}   // unnamed
+
+
+////////////////////////////////////////////////////////////////////////////////
+namespace retro
+{
+
+////////////////////////////////////////////////////////////////////////////////
+frame_limiter::frame_limiter(const double rate)
+{
+    if(!std::isfinite(rate) || rate <= 0.0)
+    {
+        throw std::invalid_argument("frame_limiter::frame_limiter has an invalid argument");
+    }
+
+    m_period = std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>{1.0 / rate});
+    reset();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+std::chrono::nanoseconds frame_limiter::period() const noexcept
+{
+    return m_period;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void frame_limiter::reset() noexcept
+{
+    m_margin = initial_margin;
+    m_deadline = {};
+    m_last = {};
+
+    m_num_samples = 0;
+    m_next_sample = 0;
+    m_missed = 0;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+frame_limiter::pacing frame_limiter::stats() const noexcept
+{
+    pacing p{};
+    p.missed = m_missed;
+
+    if(m_num_samples == 0)
+    {
+        return p;
+    }
+
+    const auto samples = std::span{m_samples}.first(m_num_samples);
+    const auto [min, max] = std::ranges::minmax(samples);
+    const auto n = static_cast<double>(samples.size());
+
+    double sum{0.0};
+    double sum_squares{0.0};
+
+    for(const auto& s : samples)
+    {
+        const auto t = std::chrono::duration<double, std::nano>{s}.count();
+        sum += t;
+        sum_squares += t * t;
+    }
+
+    const auto mean = sum / n;
+    const auto variance = std::max(sum_squares / n - mean * mean, 0.0);
+
+    p.mean = std::chrono::nanoseconds{std::llround(mean)};
+    p.min = min;
+    p.max = max;
+    p.jitter = std::chrono::nanoseconds{std::llround(std::sqrt(variance))};
+
+    return p;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void frame_limiter::wait()
+{
+    auto now = clock::now();
+
+    if(m_last == clock::time_point{})
+    {
+        m_deadline = now + m_period;
+        m_last = now;
+        return;
+    }
+
+    if(now < m_deadline)
+    {
+        // sleep through most of the wait; the margin follows the latest
+        // oversleep and decays slowly
+        if(const auto target = m_deadline - m_margin; now < target)
+        {
+            std::this_thread::sleep_until(target);
+
+            const auto late = clock::now() - target;
+            m_margin = std::clamp<clock::duration>(std::max(m_margin - m_margin / 16, late + late / 4),
+                                                   min_margin, max_margin);
+        }
+
+        while((now = clock::now()) < m_deadline)
+        {
+            std::this_thread::yield();
+        }
+    }
+    else
+    {
+        ++m_missed;
+    }
+
+    m_samples[m_next_sample] = now - m_last;
+    m_next_sample = (m_next_sample + 1) % m_samples.size();
+    m_num_samples = std::min(m_num_samples + 1, m_samples.size());
+
+    m_deadline = (now - m_deadline >= m_period) ? now + m_period : m_deadline + m_period;
+    m_last = now;
+}
+
+}   // retro
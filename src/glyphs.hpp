@@ -3,12 +3,21 @@
 // Copyright (c) 2023 Ryan Clarke
 ////////////////////////////////////////////////////////////////////////////////
 
+#ifndef RETRO_GLYPHS_HPP
+#define RETRO_GLYPHS_HPP
+
 #include <array>
 #include <cstddef>
+#include <cstdint>
+#include <ranges>
+
 
+////////////////////////////////////////////////////////////////////////////////
+namespace retro::detail
+{
 
 ////////////////////////////////////////////////////////////////////////////////
-extern constexpr std::array<std::byte, 8 * 256> glyphs_8x8
+inline constexpr std::array<std::byte, 8 * 256> glyphs_8x8
 {
     std::byte{0b00000000},
     std::byte{0b00000000},
@@ -2062,7 +2071,7 @@ extern constexpr std::array<std::byte, 8 * 256> glyphs_8x8
 
 
 ////////////////////////////////////////////////////////////////////////////////
-extern constexpr std::array<std::byte, 14 * 256> glyphs_8x14
+inline constexpr std::array<std::byte, 14 * 256> glyphs_8x14
 {
     std::byte{0b00000000},
     std::byte{0b00000000},
@@ -5652,7 +5661,7 @@ extern constexpr std::array<std::byte, 14 * 256> glyphs_8x14
 
 
 ////////////////////////////////////////////////////////////////////////////////
-extern constexpr std::array<std::byte, 16 * 256> glyphs_8x16
+inline constexpr std::array<std::byte, 16 * 256> glyphs_8x16
 {
     std::byte{0b00000000},
     std::byte{0b00000000},
@@ -9751,3 +9760,45 @@ extern constexpr std::array<std::byte, 16 * 256> glyphs_8x16
     std::byte{0b00000000},
     std::byte{0b00000000}
 };
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// \brief Pixel masks of an 8 pixel glyph row, -1 where the pixel is set and 0
+/// where it is clear, so a row renders as bg ^ ((fg ^ bg) & mask).
+////////////////////////////////////////////////////////////////////////////////
+using row_mask = std::array<std::int8_t, 8>;
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// \brief Expand every possible glyph row byte into its pixel masks.
+/// \return pixel masks indexed by row byte
+////////////////////////////////////////////////////////////////////////////////
+consteval std::array<row_mask, 256> expand_rows()
+{
+    std::array<row_mask, 256> rows{};
+
+    for(const auto bits : std::views::iota(0, 256))
+    {
+        for(const auto x : std::views::iota(0, 8))
+        {
+            rows[static_cast<std::size_t>(bits)][static_cast<std::size_t>(x)] =
+                ((bits & (0x80 >> x)) != 0) ? std::int8_t{-1} : std::int8_t{0};
+        }
+    }
+
+    return rows;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// \brief Pre-expanded rows shared by all built-in fonts, which all use 8 bit
+/// glyph rows.
+////////////////////////////////////////////////////////////////////////////////
+inline constexpr std::array<row_mask, 256> row_masks{expand_rows()};
+
+static_assert(row_masks[0x81] == row_mask{-1, 0, 0, 0, 0, 0, 0, -1});
+
+}   // retro::detail
+
+
+#endif  // RETRO_GLYPHS_HPP
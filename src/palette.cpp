@@ -0,0 +1,162 @@
+////////////////////////////////////////////////////////////////////////////////
+// Retro - Retro Computing Library
+// Copyright (c) 2023 Ryan Clarke
+////////////////////////////////////////////////////////////////////////////////
+
+#include "retro/color.hpp"
+#include "retro/vga.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+
+////////////////////////////////////////////////////////////////////////////////
+namespace retro
+{
+
+////////////////////////////////////////////////////////////////////////////////
+void vga::cycle(const int first, const int last, const std::chrono::milliseconds period)
+{
+    if(first < 0 || last >= std::ssize(m_palette) || first >= last || period <= period.zero())
+    {
+        throw std::invalid_argument("vga::cycle has an invalid argument");
+    }
+
+    m_cycles.push_back({first, last, period, clock::now() + period});
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void vga::fade(const color& target, const std::chrono::milliseconds duration)
+{
+    const std::vector<color> colors(m_palette.size(), target);
+    fade(colors, duration);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void vga::fade(const std::span<const color> target, const std::chrono::milliseconds duration)
+{
+    if(target.size() > m_palette.size() || duration < duration.zero())
+    {
+        throw std::invalid_argument("vga::fade has an invalid argument");
+    }
+
+    // entries not covered by the target keep their current color
+    palette_fade f{m_palette, clock::now(), duration};
+    std::ranges::copy(target, f.target.begin());
+
+    m_fade = std::move(f);
+    m_lut_dirty = true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void vga::fade(const color& from, const std::span<const color> target, const std::chrono::milliseconds duration)
+{
+    std::ranges::fill(m_palette, from);
+    fade(target, duration);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+bool vga::fading() const noexcept
+{
+    return m_fade.has_value();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void vga::interpolate_palette(const std::span<const color> from, const std::span<const color> to, const double t)
+{
+    if(from.size() != to.size() || from.size() > m_palette.size())
+    {
+        throw std::invalid_argument("vga::interpolate_palette has an invalid argument");
+    }
+
+    std::ranges::transform(from, to, m_palette.begin(), [=](const color& a, const color& b)
+    {
+        return lerp(a, b, t);
+    });
+
+    m_lut_dirty = true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void vga::stop_palette_effects()
+{
+    if(m_fade.has_value())
+    {
+        // keep the colors currently on screen
+        std::ranges::transform(m_lut | std::views::take(m_palette.size()), m_palette.begin(),
+                               [](const std::uint32_t argb) { return color{argb}; });
+        m_fade.reset();
+        m_lut_dirty = true;
+    }
+
+    m_cycles.clear();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void vga::update_palette()
+{
+    const auto now = clock::now();
+
+    // rotate cycling ranges by the number of elapsed steps
+    for(auto& c : m_cycles)
+    {
+        if(now < c.next)
+        {
+            continue;
+        }
+
+        const auto steps = 1 + (now - c.next) / c.period;
+        c.next += steps * c.period;
+
+        const auto first = m_palette.begin() + c.first;
+        const auto last = m_palette.begin() + c.last + 1;
+        std::rotate(first, first + (steps % (last - first)), last);
+
+        m_lut_dirty = true;
+    }
+
+    auto t = 1.0;
+
+    if(m_fade.has_value())
+    {
+        const auto elapsed = std::chrono::duration<double>(now - m_fade->start);
+        const auto duration = std::chrono::duration<double>(m_fade->duration);
+        t = (duration.count() > 0.0) ? (elapsed / duration) : 1.0;
+
+        if(t >= 1.0)
+        {
+            std::ranges::copy(m_fade->target, m_palette.begin());
+            m_fade.reset();
+        }
+
+        m_lut_dirty = true;
+    }
+
+    if(!m_lut_dirty)
+    {
+        return;
+    }
+
+    for(const auto i : std::views::iota(std::size_t{0}, m_palette.size()))
+    {
+        const auto c = m_fade.has_value() ? lerp(m_palette[i], m_fade->target[i], t) : m_palette[i];
+        m_lut[i] = c.to_argb();
+    }
+
+    m_lut_dirty = false;
+    m_palette_dirty = true;
+}
+
+}   // retro
@@ -0,0 +1,699 @@
+////////////////////////////////////////////////////////////////////////////////
+// Retro - Retro Computing Library
+// Copyright (c) 2023 Ryan Clarke
+////////////////////////////////////////////////////////////////////////////////
+
+#include "retro/vga.hpp"
+
+#include "raster_op.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+////////////////////////////////////////////////////////////////////////////////
+namespace
+{
+
+////////////////////////////////////////////////////////////////////////////////
+using raster_op = retro::vga::raster_op;
+
+
+////////////////////////////////////////////////////////////////////////////////
+struct surface
+{
+    std::span<int> vram;
+    int width{};
+    int height{};
+    int mask{};                 // palette index mask
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// \brief Ceiling division of non-negative integers.
+////////////////////////////////////////////////////////////////////////////////
+[[nodiscard]] constexpr std::int64_t ceil_div(const std::int64_t a, const std::int64_t b) noexcept
+{
+    return (a + b - 1) / b;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// \brief Draw a horizontal span.
+/// \param s drawing surface
+/// \param x0 first x location
+/// \param x1 last x location (inclusive)
+/// \param y y location
+/// \param index palette index
+////////////////////////////////////////////////////////////////////////////////
+template<raster_op Op>
+void hspan(const surface& s, int x0, int x1, const int y, const int index)
+{
+    if(x0 > x1)
+    {
+        std::swap(x0, x1);
+    }
+
+    x0 = std::max(x0, 0);
+    x1 = std::min(x1, s.width - 1);
+
+    if(y < 0 || y >= s.height || x0 > x1)
+    {
+        return;
+    }
+
+    const auto first = s.vram.begin() + static_cast<std::ptrdiff_t>(y * s.width + x0);
+    retro::detail::rop_fill<Op>(first, x1 - x0 + 1, index, s.mask);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// \brief Draw a vertical span.
+/// \param s drawing surface
+/// \param x x location
+/// \param y0 first y location
+/// \param y1 last y location (inclusive)
+/// \param index palette index
+////////////////////////////////////////////////////////////////////////////////
+template<raster_op Op>
+void vspan(const surface& s, const int x, int y0, int y1, const int index)
+{
+    if(y0 > y1)
+    {
+        std::swap(y0, y1);
+    }
+
+    y0 = std::max(y0, 0);
+    y1 = std::min(y1, s.height - 1);
+
+    if(x < 0 || x >= s.width || y0 > y1)
+    {
+        return;
+    }
+
+    auto p = s.vram.begin() + static_cast<std::ptrdiff_t>(y0 * s.width + x);
+
+    for([[maybe_unused]] const auto y : std::views::iota(y0, y1 + 1))
+    {
+        *p = retro::detail::rop<Op>::apply(*p, index, s.mask);
+        p += s.width;
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// \brief Draw a line with Bresenham's algorithm. The line is clipped to the
+/// surface once by computing the visible range of steps, so no pixel is ever
+/// tested against the bounds; each run of pixels is emitted as a span.
+/// \param s drawing surface
+/// \param x0 x location of start point
+/// \param y0 y location of start point
+/// \param x1 x location of end point
+/// \param y1 y location of end point
+/// \param index palette index
+/// \param last if true, the end point is drawn
+////////////////////////////////////////////////////////////////////////////////
+template<raster_op Op>
+void line(const surface& s, const int x0, const int y0, const int x1, const int y1, const int index,
+          const bool last)
+{
+    const auto dx = std::abs(x1 - x0);
+    const auto dy = std::abs(y1 - y0);
+    const auto x_major = dx >= dy;
+
+    // major axis a, minor axis b
+    const auto a0 = x_major ? x0 : y0;
+    const auto b0 = x_major ? y0 : x0;
+    const auto sa = ((x_major ? x1 - x0 : y1 - y0) < 0) ? -1 : 1;
+    const auto sb = ((x_major ? y1 - y0 : x1 - x0) < 0) ? -1 : 1;
+    const auto a_size = x_major ? s.width : s.height;
+    const auto b_size = x_major ? s.height : s.width;
+    const std::int64_t da = x_major ? dx : dy;
+    const std::int64_t db = x_major ? dy : dx;
+
+    // steps [i0, i1] are drawn
+    std::int64_t i0{0};
+    std::int64_t i1 = last ? da : da - 1;
+
+    if(i1 < 0)
+    {
+        return;
+    }
+
+    if(da == 0)
+    {
+        if(x0 >= 0 && x0 < s.width && y0 >= 0 && y0 < s.height)
+        {
+            hspan<Op>(s, x0, x0, y0, index);
+        }
+
+        return;
+    }
+
+    // clip major axis
+    if(sa > 0)
+    {
+        i0 = std::max<std::int64_t>(i0, -a0);
+        i1 = std::min<std::int64_t>(i1, a_size - 1 - a0);
+    }
+    else
+    {
+        i0 = std::max<std::int64_t>(i0, a0 - (a_size - 1));
+        i1 = std::min<std::int64_t>(i1, a0);
+    }
+
+    // clip minor axis, where the minor offset m(i) = floor((2 i db + da) / (2 da))
+    const auto lo = (sb > 0) ? -b0 : b0 - (b_size - 1);     // m(i) >= lo
+    const auto hi = (sb > 0) ? b_size - 1 - b0 : b0;        // m(i) <= hi
+
+    if(db == 0)
+    {
+        if(lo > 0 || hi < 0)
+        {
+            return;
+        }
+    }
+    else
+    {
+        if(lo > 0)
+        {
+            i0 = std::max(i0, ceil_div((2 * lo - 1) * da, 2 * db));
+        }
+
+        if(hi < 0)
+        {
+            return;
+        }
+
+        i1 = std::min(i1, ceil_div((2 * hi + 1) * da, 2 * db) - 1);
+    }
+
+    if(i0 > i1)
+    {
+        return;
+    }
+
+    // walk the line, emitting a span for each run of pixels on the minor axis
+    auto err = (2 * i0 * db + da) % (2 * da);
+    auto m = static_cast<int>((2 * i0 * db + da) / (2 * da));
+    auto run_start = i0;
+
+    const auto emit = [&](const std::int64_t first, const std::int64_t end)
+    {
+        const auto a_first = a0 + sa * static_cast<int>(first);
+        const auto a_end = a0 + sa * static_cast<int>(end);
+        const auto b = b0 + sb * m;
+
+        if(x_major)
+        {
+            hspan<Op>(s, a_first, a_end, b, index);
+        }
+        else
+        {
+            vspan<Op>(s, b, a_first, a_end, index);
+        }
+    };
+
+    for(const auto i : std::views::iota(i0, i1))
+    {
+        err += 2 * db;
+
+        if(err >= 2 * da)
+        {
+            emit(run_start, i);
+            err -= 2 * da;
+            ++m;
+            run_start = i + 1;
+        }
+    }
+
+    emit(run_start, i1);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// \brief Draw an ellipse with the midpoint criterion. The outline is built
+/// from whole spans per row, so every pixel is written exactly once.
+/// \param s drawing surface
+/// \param cx x location of the center
+/// \param cy y location of the center
+/// \param rx horizontal radius
+/// \param ry vertical radius
+/// \param index palette index
+/// \param fill if true, the ellipse is filled
+////////////////////////////////////////////////////////////////////////////////
+template<raster_op Op>
+void ellipse(const surface& s, const int cx, const int cy, const int rx, const int ry, const int index,
+             const bool fill)
+{
+    const std::int64_t rx2 = std::int64_t{rx} * rx;
+    const std::int64_t ry2 = std::int64_t{ry} * ry;
+    const auto limit = rx2 * ry2 + std::int64_t{rx} * ry * std::min(rx, ry);
+
+    // half width of the ellipse on a row; rows are visited in increasing order
+    auto x = rx;
+    const auto outer = [&](const std::int64_t dy)
+    {
+        while(x > 0 && (std::int64_t{x} * x * ry2 + dy * dy * rx2) > limit)
+        {
+            --x;
+        }
+
+        return x;
+    };
+
+    auto xo = outer(0);
+
+    for(const auto dy : std::views::iota(0, ry + 1))
+    {
+        // inner edge joins this row to the next one
+        const auto xn = (dy < ry) ? outer(dy + 1) : -1;
+        const auto xi = fill ? 0 : std::min(xo, xn + 1);
+
+        for(const auto y : {cy + dy, cy - dy})
+        {
+            if(xi == 0)
+            {
+                hspan<Op>(s, cx - xo, cx + xo, y, index);
+            }
+            else
+            {
+                hspan<Op>(s, cx - xo, cx - xi, y, index);
+                hspan<Op>(s, cx + xi, cx + xo, y, index);
+            }
+
+            if(dy == 0)
+            {
+                break;
+            }
+        }
+
+        xo = xn;
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// \brief Fill a polygon with a scanline algorithm and an active edge table,
+/// using the even-odd rule. Pixel centers on or right of an edge and left of
+/// the next edge are filled; bottom and right edges are excluded.
+/// \param s drawing surface
+/// \param points polygon vertices
+/// \param index palette index
+////////////////////////////////////////////////////////////////////////////////
+template<raster_op Op>
+void polygon(const surface& s, const std::span<const std::pair<int, int>> points, const int index)
+{
+    struct edge
+    {
+        int y_min{};
+        int y_max{};
+        std::int64_t x{};       // 16.16 fixed point x at the current scanline
+        std::int64_t dx{};      // 16.16 fixed point x step per scanline
+    };
+
+    std::vector<edge> edges;
+    edges.reserve(points.size());
+
+    for(const auto i : std::views::iota(std::size_t{0}, points.size()))
+    {
+        auto p = points[i];
+        auto q = points[(i + 1) % points.size()];
+
+        // horizontal edges never cross a scanline
+        if(p.second == q.second)
+        {
+            continue;
+        }
+
+        if(p.second > q.second)
+        {
+            std::swap(p, q);
+        }
+
+        const auto dx = (std::int64_t{q.first - p.first} * 65536) / (q.second - p.second);
+        edges.push_back({p.second, q.second, std::int64_t{p.first} * 65536, dx});
+    }
+
+    if(edges.empty())
+    {
+        return;
+    }
+
+    std::ranges::sort(edges, {}, &edge::y_min);
+
+    const auto y_start = std::max(0, edges.front().y_min);
+    const auto y_end = std::min(s.height, std::ranges::max(edges, {}, &edge::y_max).y_max);
+
+    std::vector<edge> active;
+    active.reserve(edges.size());
+    auto next = edges.begin();
+
+    for(const auto y : std::views::iota(y_start, std::max(y_start, y_end)))
+    {
+        // add edges starting on this scanline
+        for(; next != edges.end() && next->y_min <= y; ++next)
+        {
+            auto e = *next;
+            e.x += e.dx * (y - e.y_min);
+            active.push_back(e);
+        }
+
+        // remove edges ending on this scanline
+        std::erase_if(active, [=](const edge& e) { return e.y_max <= y; });
+
+        // edges are mostly in order from the previous scanline
+        for(auto it = active.begin(); it != active.end(); ++it)
+        {
+            std::rotate(std::upper_bound(active.begin(), it, *it,
+                                         [](const edge& a, const edge& b) { return a.x < b.x; }),
+                        it, it + 1);
+        }
+
+        for(auto it = active.begin(); (it + 1) < active.end(); it += 2)
+        {
+            const auto x0 = static_cast<int>((it->x + 0xffff) >> 16);
+            const auto x1 = static_cast<int>(((it + 1)->x + 0xffff) >> 16) - 1;
+
+            if(x0 <= x1)
+            {
+                hspan<Op>(s, x0, x1, y, index);
+            }
+        }
+
+        for(auto& e : active)
+        {
+            e.x += e.dx;
+        }
+    }
+}
+
+}   // unnamed
+
+
+////////////////////////////////////////////////////////////////////////////////
+namespace retro
+{
+
+////////////////////////////////////////////////////////////////////////////////
+void vga::draw_circle(const int cx, const int cy, const int radius, const int index, const raster_op op)
+{
+    draw_ellipse(cx, cy, radius, radius, index, op);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void vga::draw_ellipse(const int cx, const int cy, const int rx, const int ry, const int index,
+                       const raster_op op)
+{
+    if(rx < 0 || ry < 0 || index < 0 || index >= m_num_colors)
+    {
+        throw std::invalid_argument("vga::draw_ellipse has an invalid argument");
+    }
+
+    const surface s{m_vram, m_width, m_height, m_num_colors - 1};
+    m_vram_dirty = true;
+
+    detail::dispatch(op, [&]<raster_op Op>(std::integral_constant<raster_op, Op>)
+    {
+        ellipse<Op>(s, cx, cy, rx, ry, index, false);
+    });
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void vga::draw_line(const int x0, const int y0, const int x1, const int y1, const int index,
+                    const raster_op op)
+{
+    if(index < 0 || index >= m_num_colors)
+    {
+        throw std::invalid_argument("vga::draw_line has an invalid argument");
+    }
+
+    const surface s{m_vram, m_width, m_height, m_num_colors - 1};
+    m_vram_dirty = true;
+
+    detail::dispatch(op, [&]<raster_op Op>(std::integral_constant<raster_op, Op>)
+    {
+        line<Op>(s, x0, y0, x1, y1, index, true);
+    });
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void vga::draw_polygon(const std::span<const std::pair<int, int>> points, const int index, const raster_op op)
+{
+    if(index < 0 || index >= m_num_colors)
+    {
+        throw std::invalid_argument("vga::draw_polygon has an invalid argument");
+    }
+
+    const surface s{m_vram, m_width, m_height, m_num_colors - 1};
+    m_vram_dirty = true;
+
+    // each edge omits its end point, so shared vertices are drawn once
+    detail::dispatch(op, [&]<raster_op Op>(std::integral_constant<raster_op, Op>)
+    {
+        for(const auto i : std::views::iota(std::size_t{0}, points.size()))
+        {
+            const auto [x0, y0] = points[i];
+            const auto [x1, y1] = points[(i + 1) % points.size()];
+            line<Op>(s, x0, y0, x1, y1, index, points.size() == 1);
+        }
+    });
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void vga::draw_rect(const rect& r, const int index, const raster_op op)
+{
+    if(r.width < 0 || r.height < 0 || index < 0 || index >= m_num_colors)
+    {
+        throw std::invalid_argument("vga::draw_rect has an invalid argument");
+    }
+
+    if(r.width == 0 || r.height == 0)
+    {
+        return;
+    }
+
+    const surface s{m_vram, m_width, m_height, m_num_colors - 1};
+    m_vram_dirty = true;
+    const auto right = r.x + r.width - 1;
+    const auto bottom = r.y + r.height - 1;
+
+    // sides exclude the corners, so no pixel is written twice
+    detail::dispatch(op, [&]<raster_op Op>(std::integral_constant<raster_op, Op>)
+    {
+        hspan<Op>(s, r.x, right, r.y, index);
+
+        if(bottom > r.y)
+        {
+            hspan<Op>(s, r.x, right, bottom, index);
+        }
+
+        if(bottom - 1 > r.y)
+        {
+            vspan<Op>(s, r.x, r.y + 1, bottom - 1, index);
+
+            if(right > r.x)
+            {
+                vspan<Op>(s, right, r.y + 1, bottom - 1, index);
+            }
+        }
+    });
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void vga::fill_circle(const int cx, const int cy, const int radius, const int index, const raster_op op)
+{
+    fill_ellipse(cx, cy, radius, radius, index, op);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void vga::fill_ellipse(const int cx, const int cy, const int rx, const int ry, const int index,
+                       const raster_op op)
+{
+    if(rx < 0 || ry < 0 || index < 0 || index >= m_num_colors)
+    {
+        throw std::invalid_argument("vga::fill_ellipse has an invalid argument");
+    }
+
+    const surface s{m_vram, m_width, m_height, m_num_colors - 1};
+    m_vram_dirty = true;
+
+    detail::dispatch(op, [&]<raster_op Op>(std::integral_constant<raster_op, Op>)
+    {
+        ellipse<Op>(s, cx, cy, rx, ry, index, true);
+    });
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void vga::fill_polygon(const std::span<const std::pair<int, int>> points, const int index, const raster_op op)
+{
+    if(index < 0 || index >= m_num_colors)
+    {
+        throw std::invalid_argument("vga::fill_polygon has an invalid argument");
+    }
+
+    const surface s{m_vram, m_width, m_height, m_num_colors - 1};
+    m_vram_dirty = true;
+
+    detail::dispatch(op, [&]<raster_op Op>(std::integral_constant<raster_op, Op>)
+    {
+        polygon<Op>(s, points, index);
+    });
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void vga::fill_rect(const rect& r, const int index, const raster_op op)
+{
+    if(r.width < 0 || r.height < 0 || index < 0 || index >= m_num_colors)
+    {
+        throw std::invalid_argument("vga::fill_rect has an invalid argument");
+    }
+
+    const auto x0 = std::max(r.x, 0);
+    const auto y0 = std::max(r.y, 0);
+    const auto x1 = std::min(r.x + r.width, m_width);
+    const auto y1 = std::min(r.y + r.height, m_height);
+
+    if(x0 >= x1 || y0 >= y1)
+    {
+        return;
+    }
+
+    const auto mask = m_num_colors - 1;
+    m_vram_dirty = true;
+
+    detail::dispatch(op, [&]<raster_op Op>(std::integral_constant<raster_op, Op>)
+    {
+        for(const auto y : std::views::iota(y0, y1))
+        {
+            const auto first = m_vram.begin() + static_cast<std::ptrdiff_t>(xy_to_index(x0, y));
+            detail::rop_fill<Op>(first, x1 - x0, index, mask);
+        }
+    });
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void vga::flood_fill(const int x, const int y, const int index)
+{
+    if(index < 0 || index >= m_num_colors)
+    {
+        throw std::invalid_argument("vga::flood_fill has an invalid argument");
+    }
+
+    if(x < 0 || x >= m_width || y < 0 || y >= m_height)
+    {
+        return;
+    }
+
+    const auto old_index = m_vram[xy_to_index(x, y)];
+
+    if(old_index == index)
+    {
+        return;
+    }
+
+    m_vram_dirty = true;
+
+    // Heckbert's span-stack seed fill: each entry is a span of the parent
+    // line [x0, x1] at y, to be scanned on line y + dy
+    auto& stack = m_fill_stack;
+    stack.clear();
+
+    const auto push = [&](const int sy, const int x0, const int x1, const int dy)
+    {
+        if(sy + dy >= 0 && sy + dy < m_height)
+        {
+            stack.push_back({x0, x1, sy, dy});
+        }
+    };
+
+    push(y, x, x, 1);
+    push(y + 1, x, x, -1);
+
+    while(!stack.empty())
+    {
+        const auto [x1, x2, parent_y, dy] = stack.back();
+        stack.pop_back();
+
+        const auto line = parent_y + dy;
+        const auto row = m_vram.begin() + static_cast<std::ptrdiff_t>(xy_to_index(0, line));
+
+        // extend left of the parent span
+        auto sx = x1;
+
+        while(sx >= 0 && row[sx] == old_index)
+        {
+            --sx;
+        }
+
+        std::fill(row + sx + 1, row + x1 + 1, index);
+
+        auto left = sx + 1;
+        auto skip = sx >= x1;
+
+        if(!skip)
+        {
+            // leak on the left
+            if(left < x1)
+            {
+                push(line, left, x1 - 1, -dy);
+            }
+
+            sx = x1 + 1;
+        }
+
+        while(true)
+        {
+            if(!skip)
+            {
+                const auto first = sx;
+
+                while(sx < m_width && row[sx] == old_index)
+                {
+                    ++sx;
+                }
+
+                std::fill(row + first, row + sx, index);
+                push(line, left, sx - 1, dy);
+
+                // leak on the right
+                if(sx > x2 + 1)
+                {
+                    push(line, x2 + 1, sx - 1, -dy);
+                }
+            }
+
+            skip = false;
+
+            // skip to the next fillable pixel under the parent span
+            for(++sx; sx <= x2 && row[sx] != old_index; ++sx)
+            {
+            }
+
+            left = sx;
+
+            if(sx > x2)
+            {
+                break;
+            }
+        }
+    }
+}
+
+}   // retro
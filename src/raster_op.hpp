@@ -0,0 +1,161 @@
+////////////////////////////////////////////////////////////////////////////////
+// Retro - Retro Computing Library
+// Copyright (c) 2023 Ryan Clarke
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef RETRO_RASTER_OP_HPP
+#define RETRO_RASTER_OP_HPP
+
+#include "retro/vga.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+
+////////////////////////////////////////////////////////////////////////////////
+namespace retro::detail
+{
+
+////////////////////////////////////////////////////////////////////////////////
+/// \brief Combine a source pixel with a destination pixel.
+////////////////////////////////////////////////////////////////////////////////
+template<vga::raster_op Op>
+struct rop;
+
+template<>
+struct rop<vga::raster_op::copy>
+{
+    static constexpr int apply(int, const int src, int) noexcept { return src; }
+};
+
+template<>
+struct rop<vga::raster_op::logical_and>
+{
+    static constexpr int apply(const int dst, const int src, int) noexcept { return dst & src; }
+};
+
+template<>
+struct rop<vga::raster_op::logical_or>
+{
+    static constexpr int apply(const int dst, const int src, int) noexcept { return dst | src; }
+};
+
+template<>
+struct rop<vga::raster_op::logical_xor>
+{
+    static constexpr int apply(const int dst, const int src, int) noexcept { return dst ^ src; }
+};
+
+template<>
+struct rop<vga::raster_op::add>
+{
+    static constexpr int apply(const int dst, const int src, const int mask) noexcept
+    {
+        return (dst + src) & mask;
+    }
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// \brief Call a function with the raster operation as a compile-time
+/// constant, so the per-pixel loops are specialized for each operation.
+/// \param op raster operation
+/// \param f function taking a std::integral_constant<vga::raster_op, Op>
+////////////////////////////////////////////////////////////////////////////////
+template<typename F>
+decltype(auto) dispatch(const vga::raster_op op, F&& f)
+{
+    using enum vga::raster_op;
+
+    switch(op)
+    {
+        case logical_and:
+            return std::forward<F>(f)(std::integral_constant<vga::raster_op, logical_and>{});
+
+        case logical_or:
+            return std::forward<F>(f)(std::integral_constant<vga::raster_op, logical_or>{});
+
+        case logical_xor:
+            return std::forward<F>(f)(std::integral_constant<vga::raster_op, logical_xor>{});
+
+        case add:
+            return std::forward<F>(f)(std::integral_constant<vga::raster_op, add>{});
+
+        case copy:
+        default:
+            return std::forward<F>(f)(std::integral_constant<vga::raster_op, copy>{});
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// \brief Combine a span of source pixels with the destination.
+/// \param src source pixels
+/// \param dst destination pixels
+/// \param mask palette index mask
+////////////////////////////////////////////////////////////////////////////////
+template<vga::raster_op Op, typename It>
+void rop_copy(const std::span<const int> src, const It dst, const int mask)
+{
+    if constexpr(Op == vga::raster_op::copy)
+    {
+        std::ranges::copy(src, dst);
+    }
+    else
+    {
+        std::transform(src.begin(), src.end(), dst, dst, [=](const int s, const int d)
+        {
+            return rop<Op>::apply(d, s, mask);
+        });
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// \brief Combine a span of source pixels with the destination, skipping
+/// pixels matching the color key.
+/// \param src source pixels
+/// \param dst destination pixels
+/// \param key transparent color key
+/// \param mask palette index mask
+////////////////////////////////////////////////////////////////////////////////
+template<vga::raster_op Op, typename It>
+void rop_copy_keyed(const std::span<const int> src, const It dst, const int key, const int mask)
+{
+    std::transform(src.begin(), src.end(), dst, dst, [=](const int s, const int d)
+    {
+        return (s == key) ? d : rop<Op>::apply(d, s, mask);
+    });
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// \brief Combine a run of destination pixels with a single color.
+/// \param dst first destination pixel
+/// \param count number of pixels
+/// \param index palette index
+/// \param mask palette index mask
+////////////////////////////////////////////////////////////////////////////////
+template<vga::raster_op Op, typename It>
+void rop_fill(const It dst, const std::ptrdiff_t count, const int index, const int mask)
+{
+    if constexpr(Op == vga::raster_op::copy)
+    {
+        std::fill_n(dst, count, index);
+    }
+    else
+    {
+        std::transform(dst, dst + count, dst, [=](const int d)
+        {
+            return rop<Op>::apply(d, index, mask);
+        });
+    }
+}
+
+}   // retro::detail
+
+
+#endif  // RETRO_RASTER_OP_HPP
@@ -0,0 +1,255 @@
+////////////////////////////////////////////////////////////////////////////////
+// Retro - Retro Computing Library
+// Copyright (c) 2023 Ryan Clarke
+////////////////////////////////////////////////////////////////////////////////
+
+#include "retro/scrollback.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+
+////////////////////////////////////////////////////////////////////////////////
+namespace
+{
+
+////////////////////////////////////////////////////////////////////////////////
+constexpr std::size_t max_run_length{std::numeric_limits<std::uint8_t>::max()};
+constexpr std::size_t min_data_size{4096};
+
+
+////////////////////////////////////////////////////////////////////////////////
+constexpr bool same_attributes(const retro::text_cell& a, const retro::text_cell& b) noexcept
+{
+    return a.fg == b.fg && a.bg == b.bg && (a.glyph >> 8) == (b.glyph >> 8);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// \brief Call a function for each run of cells with the same attributes.
+/// \param cells cells of a line
+/// \param f function called with the first cell and the length of each run
+////////////////////////////////////////////////////////////////////////////////
+template<typename F>
+void for_each_run(const std::span<const retro::text_cell> cells, F f)
+{
+    std::size_t first{0};
+
+    for(std::size_t i{1}; i <= cells.size(); ++i)
+    {
+        if(i == cells.size() || i - first == max_run_length || !same_attributes(cells[first], cells[i]))
+        {
+            f(cells[first], i - first);
+            first = i;
+        }
+    }
+}
+
+}   // unnamed
+
+
+////////////////////////////////////////////////////////////////////////////////
+namespace retro
+{
+
+////////////////////////////////////////////////////////////////////////////////
+scrollback::scrollback(const std::size_t depth)
+    : m_lines(depth)
+{
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void scrollback::clear() noexcept
+{
+    m_first = 0;
+    m_count = 0;
+    m_head = 0;
+    m_tail = 0;
+    m_used = 0;
+    m_wrapped = false;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+std::size_t scrollback::depth() const noexcept
+{
+    return m_lines.size();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void scrollback::line(const std::size_t age, const std::span<text_cell> cells) const
+{
+    if(age >= m_count)
+    {
+        throw std::invalid_argument("scrollback::line has an invalid argument");
+    }
+
+    const auto& r = nth(m_count - 1 - age);
+    const auto data = std::span{m_data}.subspan(r.offset, r.glyphs + r.runs * run_size);
+    const auto glyphs = data.first(r.glyphs);
+    auto runs = data.subspan(r.glyphs);
+
+    std::ranges::fill(cells, text_cell{});
+
+    for(std::size_t col{0}; !runs.empty(); runs = runs.subspan(run_size))
+    {
+        const auto high = static_cast<unsigned>(runs[3]) << 8;
+
+        for(const auto end = col + runs[0]; col < end && col < cells.size(); ++col)
+        {
+            cells[col] = {static_cast<std::uint16_t>(high | glyphs[col]), runs[1], runs[2]};
+        }
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+std::size_t scrollback::memory_usage() const noexcept
+{
+    return m_data.capacity() + m_lines.capacity() * sizeof(record);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void scrollback::push(const std::span<const text_cell> cells)
+{
+    if(m_lines.empty())
+    {
+        return;
+    }
+
+    // trailing empty cells are not stored
+    auto length = std::min(cells.size(), std::size_t{std::numeric_limits<std::uint16_t>::max()});
+
+    while(length > 0 && cells[length - 1] == text_cell{})
+    {
+        --length;
+    }
+
+    const auto line = cells.first(length);
+
+    std::size_t runs{0};
+    for_each_run(line, [&](const text_cell&, std::size_t) { ++runs; });
+
+    if(m_count == m_lines.size())
+    {
+        drop();
+    }
+
+    const auto size = length + runs * run_size;
+
+    if(m_used == 0)
+    {
+        m_head = 0;
+        m_tail = 0;
+        m_wrapped = false;
+    }
+
+    // the record goes after the newest one, or at the start of the ring if it
+    // does not fit before the end; if neither space is free, the ring grows
+    std::size_t offset{m_head};
+
+    if(m_wrapped ? (m_head + size > m_tail) : (m_head + size > m_data.size()))
+    {
+        if(!m_wrapped && size <= m_tail)
+        {
+            offset = 0;
+            m_end = m_head;
+            m_wrapped = true;
+        }
+        else
+        {
+            grow(size);
+            offset = m_head;
+        }
+    }
+
+    auto out = m_data.begin() + static_cast<std::ptrdiff_t>(offset);
+    out = std::ranges::transform(line, out, [](const text_cell& c) { return static_cast<std::uint8_t>(c.glyph); }).out;
+
+    for_each_run(line, [&](const text_cell& c, const std::size_t n)
+    {
+        *out++ = static_cast<std::uint8_t>(n);
+        *out++ = c.fg;
+        *out++ = c.bg;
+        *out++ = static_cast<std::uint8_t>(c.glyph >> 8);
+    });
+
+    m_lines[(m_first + m_count) % m_lines.size()] = {static_cast<std::uint32_t>(offset),
+                                                     static_cast<std::uint16_t>(length),
+                                                     static_cast<std::uint16_t>(runs)};
+    ++m_count;
+    m_head = offset + size;
+    m_used += size;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+std::size_t scrollback::size() const noexcept
+{
+    return m_count;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void scrollback::drop() noexcept
+{
+    const auto& r = nth(0);
+
+    // empty records take no space, so only non-empty ones move the tail
+    if(const auto size = r.glyphs + r.runs * run_size; size > 0)
+    {
+        m_used -= size;
+        m_tail = r.offset + size;
+
+        if(m_wrapped && m_tail == m_end)
+        {
+            m_tail = 0;
+            m_wrapped = false;
+        }
+    }
+
+    m_first = (m_first + 1) % m_lines.size();
+    --m_count;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void scrollback::grow(const std::size_t needed)
+{
+    std::vector<std::uint8_t> data(std::max((m_used + needed) * 2, min_data_size));
+    std::size_t offset{0};
+
+    for(std::size_t i{0}; i < m_count; ++i)
+    {
+        auto& r = m_lines[(m_first + i) % m_lines.size()];
+        const auto first = m_data.begin() + r.offset;
+        const auto size = static_cast<std::ptrdiff_t>(r.glyphs + r.runs * run_size);
+
+        std::copy(first, first + size, data.begin() + static_cast<std::ptrdiff_t>(offset));
+        r.offset = static_cast<std::uint32_t>(offset);
+        offset += static_cast<std::size_t>(size);
+    }
+
+    m_data = std::move(data);
+    m_head = offset;
+    m_tail = 0;
+    m_wrapped = false;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+const scrollback::record& scrollback::nth(const std::size_t i) const noexcept
+{
+    return m_lines[(m_first + i) % m_lines.size()];
+}
+
+}   // retro
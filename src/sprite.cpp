@@ -40,6 +40,25 @@ sprite::sprite(const int width, const int height, const std::optional<std::span<
 }
 
 
+////////////////////////////////////////////////////////////////////////////////
+void sprite::color_key(const std::optional<int> key)
+{
+    if(key.has_value() && (key.value() < 0 || key.value() > 255))
+    {
+        throw std::invalid_argument("sprite::color_key has an invalid argument");
+    }
+
+    m_color_key = key;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+std::optional<int> sprite::color_key() const noexcept
+{
+    return m_color_key;
+}
+
+
 ////////////////////////////////////////////////////////////////////////////////
 void sprite::fill(const int color)
 {
@@ -0,0 +1,111 @@
+////////////////////////////////////////////////////////////////////////////////
+// Retro - Retro Computing Library
+// Copyright (c) 2023 Ryan Clarke
+////////////////////////////////////////////////////////////////////////////////
+
+#include "retro/atlas.hpp"
+#include "retro/sprite.hpp"
+#include "retro/sprite_batch.hpp"
+
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+
+////////////////////////////////////////////////////////////////////////////////
+namespace
+{
+
+////////////////////////////////////////////////////////////////////////////////
+/// \brief Test if a flag is set.
+/// \param f flags
+/// \param flag flag to test
+/// \return true if \a flag is set in \a f
+////////////////////////////////////////////////////////////////////////////////
+[[nodiscard]] constexpr bool has_flag(const retro::sprite_batch::flags f,
+                                      const retro::sprite_batch::flags flag) noexcept
+{
+    return (f & flag) != retro::sprite_batch::flags::none;
+}
+
+}   // unnamed
+
+
+////////////////////////////////////////////////////////////////////////////////
+namespace retro
+{
+
+////////////////////////////////////////////////////////////////////////////////
+void sprite_batch::add(const sprite& source, const int z, const flags f)
+{
+    if(has_flag(f, flags::hidden))
+    {
+        return;
+    }
+
+    const auto [x, y] = source.position();
+    const auto [width, height] = source.size();
+    const auto& pixels = source.pixels();
+
+    if(std::ssize(pixels) < width * height)
+    {
+        throw std::invalid_argument("sprite_batch::add has an invalid argument");
+    }
+
+    const auto key = has_flag(f, flags::opaque) ? std::nullopt : source.color_key();
+    m_entries.push_back({pixels, width, {0, 0, width, height}, x, y, z, key});
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void sprite_batch::add(const atlas& source, const rect& frame, const int x, const int y, const int z,
+                       const flags f)
+{
+    if(has_flag(f, flags::hidden))
+    {
+        return;
+    }
+
+    const auto [width, height] = source.size();
+
+    if(frame.x < 0 || frame.y < 0 || frame.width < 0 || frame.height < 0 ||
+       frame.x + frame.width > width || frame.y + frame.height > height)
+    {
+        throw std::invalid_argument("sprite_batch::add has an invalid argument");
+    }
+
+    const auto key = has_flag(f, flags::opaque) ? std::nullopt : source.color_key();
+    m_entries.push_back({source.pixels(), width, frame, x, y, z, key});
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void sprite_batch::clear() noexcept
+{
+    m_entries.clear();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+std::span<const sprite_batch::entry> sprite_batch::entries() const noexcept
+{
+    return m_entries;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void sprite_batch::reserve(const std::size_t count)
+{
+    m_entries.reserve(count);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+std::size_t sprite_batch::size() const noexcept
+{
+    return m_entries.size();
+}
+
+}   // retro
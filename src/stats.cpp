@@ -0,0 +1,100 @@
+////////////////////////////////////////////////////////////////////////////////
+// Retro - Retro Computing Library
+// Copyright (c) 2023 Ryan Clarke
+////////////////////////////////////////////////////////////////////////////////
+
+#include "stats.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+
+////////////////////////////////////////////////////////////////////////////////
+namespace
+{
+
+////////////////////////////////////////////////////////////////////////////////
+std::atomic<std::size_t> allocations{0};
+
+}   // unnamed
+
+
+////////////////////////////////////////////////////////////////////////////////
+namespace retro::detail
+{
+
+////////////////////////////////////////////////////////////////////////////////
+std::size_t allocation_count() noexcept
+{
+    return allocations.load(std::memory_order_relaxed);
+}
+
+}   // retro::detail
+
+
+#ifdef RETRO_ENABLE_STATS
+////////////////////////////////////////////////////////////////////////////////
+// The global allocation functions are replaced to count allocations. The
+// array and nothrow forms call these by default.
+////////////////////////////////////////////////////////////////////////////////
+void* operator new(const std::size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+
+    if(auto* p = std::malloc(size == 0 ? 1 : size); p != nullptr)
+    {
+        return p;
+    }
+
+    throw std::bad_alloc{};
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void* operator new(const std::size_t size, const std::align_val_t alignment)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+
+    // aligned_alloc needs a size that is a multiple of the alignment
+    const auto align = static_cast<std::size_t>(alignment);
+    const auto rounded = (std::max(size, std::size_t{1}) + align - 1) / align * align;
+
+    if(auto* p = std::aligned_alloc(align, rounded); p != nullptr)
+    {
+        return p;
+    }
+
+    throw std::bad_alloc{};
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void operator delete(void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void operator delete(void* p, std::align_val_t) noexcept
+{
+    std::free(p);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept
+{
+    std::free(p);
+}
+#endif
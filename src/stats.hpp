@@ -0,0 +1,76 @@
+////////////////////////////////////////////////////////////////////////////////
+// Retro - Retro Computing Library
+// Copyright (c) 2023 Ryan Clarke
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef RETRO_STATS_HPP
+#define RETRO_STATS_HPP
+
+#include <chrono>
+#include <cstddef>
+
+
+////////////////////////////////////////////////////////////////////////////////
+namespace retro::detail
+{
+
+////////////////////////////////////////////////////////////////////////////////
+#ifdef RETRO_ENABLE_STATS
+inline constexpr bool stats_enabled{true};
+#else
+inline constexpr bool stats_enabled{false};
+#endif
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// \brief Get the number of heap allocations made by the process. Allocations
+/// are only counted when stats are enabled.
+/// \return number of allocations
+////////////////////////////////////////////////////////////////////////////////
+[[nodiscard]] std::size_t allocation_count() noexcept;
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// \brief Add the time spent in a scope to a counter.
+////////////////////////////////////////////////////////////////////////////////
+class scoped_timer
+{
+  public:
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Start timing.
+    /// \param total counter the time is added to
+    /// \param enabled false to time nothing
+    ////////////////////////////////////////////////////////////////////////////
+    scoped_timer(std::chrono::nanoseconds& total, const bool enabled) noexcept
+        : m_total{total},
+          m_enabled{enabled}
+    {
+        if(m_enabled)
+        {
+            m_start = clock::now();
+        }
+    }
+
+    ~scoped_timer()
+    {
+        if(m_enabled)
+        {
+            m_total += clock::now() - m_start;
+        }
+    }
+
+    scoped_timer(const scoped_timer&) = delete;
+    scoped_timer& operator=(const scoped_timer&) = delete;
+
+  private:
+    using clock = std::chrono::steady_clock;
+
+    std::chrono::nanoseconds& m_total;
+    bool m_enabled;
+    clock::time_point m_start;
+};
+
+}   // retro::detail
+
+
+#endif  // RETRO_STATS_HPP
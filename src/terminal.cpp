@@ -0,0 +1,683 @@
+////////////////////////////////////////////////////////////////////////////////
+// Retro - Retro Computing Library
+// Copyright (c) 2023 Ryan Clarke
+////////////////////////////////////////////////////////////////////////////////
+
+#include "retro/terminal.hpp"
+#include "retro/font.hpp"
+#include "retro/vga.hpp"
+
+#include "utf8.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <ranges>
+#include <string_view>
+#include <tuple>
+#include <utility>
+
+
+////////////////////////////////////////////////////////////////////////////////
+namespace
+{
+
+////////////////////////////////////////////////////////////////////////////////
+// VGA color of each ANSI color: black, red, green, yellow, blue, magenta,
+// cyan, white
+constexpr std::array<int, 8> ansi_colors{0, 4, 2, 6, 1, 5, 3, 7};
+
+}   // unnamed
+
+
+////////////////////////////////////////////////////////////////////////////////
+namespace retro
+{
+
+////////////////////////////////////////////////////////////////////////////////
+terminal::terminal(vga& display, const charset input)
+    : m_vga{display}, m_font{display.get_font()}, m_charset{input}
+{
+    std::tie(m_columns, m_rows) = m_vga.get_text_size();
+
+    for(const auto c : std::views::iota(0, 128))
+    {
+        m_ascii[static_cast<std::size_t>(c)] = (m_charset == charset::cp437) ? c : m_font.index(static_cast<char32_t>(c));
+    }
+
+    m_space = m_ascii[' '];
+    m_replacement = m_font.index(detail::replacement_character);
+
+    m_cells.resize(static_cast<std::size_t>(m_columns * m_rows));
+    m_dirty.resize(static_cast<std::size_t>(m_rows));
+
+    reset();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+std::pair<int, int> terminal::cursor() const noexcept
+{
+    return {m_col, m_row};
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void terminal::on_bell(std::function<void()> f)
+{
+    m_bell = std::move(f);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void terminal::render()
+{
+    for(const auto row : std::views::iota(0, m_rows))
+    {
+        if(m_dirty[static_cast<std::size_t>(row)] == 0u)
+        {
+            continue;
+        }
+
+        const auto first = m_cells.begin() + row * m_columns;
+
+        for(const auto col : std::views::iota(0, m_columns))
+        {
+            const auto& c = first[col];
+            m_vga.put_glyph(col, row, c.glyph, c.fg, c.bg);
+        }
+
+        m_dirty[static_cast<std::size_t>(row)] = 0u;
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void terminal::reset()
+{
+    m_state = state::ground;
+    m_utf8_remaining = 0;
+    m_attr = {};
+    m_saved_attr = {};
+    m_col = m_saved_col = 0;
+    m_row = m_saved_row = 0;
+    m_wrap_pending = false;
+    m_top = 0;
+    m_bottom = m_rows - 1;
+    m_newline_mode = true;
+
+    erase(0, m_columns * m_rows);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void terminal::write(const std::string_view bytes)
+{
+    for(auto it = bytes.begin(); it != bytes.end(); ++it)
+    {
+        // printable ASCII is by far the most common input
+        if(m_state == state::ground && m_utf8_remaining == 0)
+        {
+            while(it != bytes.end() && *it >= 0x20 && *it < 0x7f)
+            {
+                put(m_ascii[static_cast<std::size_t>(*it)]);
+                ++it;
+            }
+
+            if(it == bytes.end())
+            {
+                break;
+            }
+        }
+
+        const auto c = static_cast<unsigned char>(*it);
+
+        // a UTF-8 sequence interrupted by any other byte is malformed
+        if(m_utf8_remaining > 0)
+        {
+            if((c & 0xc0u) == 0x80u)
+            {
+                m_code_point = (m_code_point << 6) | (c & 0x3fu);
+
+                if(--m_utf8_remaining == 0)
+                {
+                    const auto valid = m_code_point >= m_utf8_min && m_code_point <= 0x10ffff &&
+                                       (m_code_point < 0xd800 || m_code_point > 0xdfff);
+                    put(valid ? m_font.index(m_code_point) : m_replacement);
+                }
+
+                continue;
+            }
+
+            m_utf8_remaining = 0;
+            put(m_replacement);
+        }
+
+        if(c < 0x20 || c == 0x7f)
+        {
+            control(c);
+            continue;
+        }
+
+        switch(m_state)
+        {
+            case state::ground:
+                if(c < 0x80 || m_charset == charset::cp437)
+                {
+                    put((c < 0x80) ? m_ascii[c] : c);
+                }
+                else if(c >= 0xc2 && c <= 0xf4)
+                {
+                    m_utf8_remaining = (c < 0xe0) ? 1 : (c < 0xf0) ? 2 : 3;
+                    m_utf8_min = (c < 0xe0) ? 0x80 : (c < 0xf0) ? 0x800 : 0x10000;
+                    m_code_point = c & (0x3fu >> m_utf8_remaining);
+                }
+                else
+                {
+                    put(m_replacement);
+                }
+                break;
+
+            case state::escape:
+                escape_dispatch(c);
+                break;
+
+            case state::escape_charset:
+                m_state = state::ground;
+                break;
+
+            case state::csi:
+                if(c >= '0' && c <= '9')
+                {
+                    auto& p = m_params[m_num_params - 1];
+                    p = std::min(p * 10 + (c - '0'), 9999);
+                }
+                else if(c == ';')
+                {
+                    // extra parameters are dropped
+                    if(m_num_params < max_params)
+                    {
+                        m_params[m_num_params++] = 0;
+                    }
+                }
+                else if(c == '?')
+                {
+                    m_private = true;
+                }
+                else if(c >= 0x40 && c <= 0x7e)
+                {
+                    csi_dispatch(c);
+                    m_state = state::ground;
+                }
+                break;
+
+            case state::osc:
+                break;
+        }
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+terminal::cell terminal::blank() const noexcept
+{
+    // bold brightens the standard colors
+    const auto bright = (m_attr.bold && m_attr.fg < 8) ? m_attr.fg + 8 : m_attr.fg;
+    const auto fg = m_attr.reverse ? m_attr.bg : bright;
+    const auto bg = m_attr.reverse ? bright : m_attr.bg;
+
+    return {m_space, static_cast<std::uint8_t>(fg), static_cast<std::uint8_t>(bg)};
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void terminal::control(const unsigned char c)
+{
+    switch(c)
+    {
+        case '\a':
+            // BEL also ends an operating system command
+            if(m_state == state::osc)
+            {
+                m_state = state::ground;
+            }
+            else if(m_bell)
+            {
+                m_bell();
+            }
+            break;
+
+        case '\b':
+            m_col = std::max(0, m_col - 1);
+            m_wrap_pending = false;
+            break;
+
+        case '\t':
+            m_col = std::min((m_col / 8 + 1) * 8, m_columns - 1);
+            m_wrap_pending = false;
+            break;
+
+        case '\n':
+        case '\v':
+        case '\f':
+            line_feed();
+            if(m_newline_mode)
+            {
+                m_col = 0;
+            }
+            break;
+
+        case '\r':
+            m_col = 0;
+            m_wrap_pending = false;
+            break;
+
+        case 0x18:      // CAN
+        case 0x1a:      // SUB
+            m_state = state::ground;
+            break;
+
+        case 0x1b:      // ESC
+            m_state = state::escape;
+            break;
+
+        default:
+            break;
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void terminal::csi_dispatch(const unsigned char final)
+{
+    const auto n = param(0, 1);
+
+    // private modes (cursor visibility and the like) are not emulated
+    if(m_private)
+    {
+        return;
+    }
+
+    switch(final)
+    {
+        case 'A':
+            move_to(m_col, std::max(m_row - n, (m_row >= m_top) ? m_top : 0));
+            break;
+
+        case 'B':
+            move_to(m_col, std::min(m_row + n, (m_row <= m_bottom) ? m_bottom : m_rows - 1));
+            break;
+
+        case 'C':
+            move_to(m_col + n, m_row);
+            break;
+
+        case 'D':
+            move_to(m_col - n, m_row);
+            break;
+
+        case 'E':
+            move_to(0, m_row + n);
+            break;
+
+        case 'F':
+            move_to(0, m_row - n);
+            break;
+
+        case 'G':
+            move_to(n - 1, m_row);
+            break;
+
+        case 'H':
+        case 'f':
+            move_to(param(1, 1) - 1, n - 1);
+            break;
+
+        case 'd':
+            move_to(m_col, n - 1);
+            break;
+
+        case 'J':
+            switch(param(0, 0))
+            {
+                case 0:
+                    erase(m_row * m_columns + m_col, m_columns * m_rows);
+                    break;
+                case 1:
+                    erase(0, m_row * m_columns + m_col + 1);
+                    break;
+                default:
+                    erase(0, m_columns * m_rows);
+                    break;
+            }
+            break;
+
+        case 'K':
+            switch(param(0, 0))
+            {
+                case 0:
+                    erase(m_row * m_columns + m_col, (m_row + 1) * m_columns);
+                    break;
+                case 1:
+                    erase(m_row * m_columns, m_row * m_columns + m_col + 1);
+                    break;
+                default:
+                    erase(m_row * m_columns, (m_row + 1) * m_columns);
+                    break;
+            }
+            break;
+
+        case 'X':
+            erase(m_row * m_columns + m_col, m_row * m_columns + std::min(m_col + n, m_columns));
+            break;
+
+        case '@':
+        case 'P':
+        {
+            // insert or delete characters, shifting the rest of the line
+            const auto row = m_cells.begin() + m_row * m_columns;
+            const auto count = std::min(n, m_columns - m_col);
+
+            if(final == '@')
+            {
+                std::shift_right(row + m_col, row + m_columns, count);
+                std::fill_n(row + m_col, count, blank());
+            }
+            else
+            {
+                std::shift_left(row + m_col, row + m_columns, count);
+                std::fill(row + m_columns - count, row + m_columns, blank());
+            }
+
+            m_dirty[static_cast<std::size_t>(m_row)] = 1u;
+            break;
+        }
+
+        case 'L':
+            if(m_row >= m_top && m_row <= m_bottom)
+            {
+                scroll_down(m_row, m_bottom, n);
+                m_col = 0;
+            }
+            break;
+
+        case 'M':
+            if(m_row >= m_top && m_row <= m_bottom)
+            {
+                scroll_up(m_row, m_bottom, n);
+                m_col = 0;
+            }
+            break;
+
+        case 'S':
+            scroll_up(m_top, m_bottom, n);
+            break;
+
+        case 'T':
+            scroll_down(m_top, m_bottom, n);
+            break;
+
+        case 'h':
+        case 'l':
+            if(param(0, 0) == 20)
+            {
+                m_newline_mode = (final == 'h');
+            }
+            break;
+
+        case 'm':
+            select_graphic_rendition();
+            break;
+
+        case 'r':
+        {
+            const auto top = param(0, 1) - 1;
+            const auto bottom = std::min(param(1, m_rows), m_rows) - 1;
+
+            if(top < bottom)
+            {
+                m_top = top;
+                m_bottom = bottom;
+                move_to(0, 0);
+            }
+            break;
+        }
+
+        case 's':
+            m_saved_col = m_col;
+            m_saved_row = m_row;
+            break;
+
+        case 'u':
+            move_to(m_saved_col, m_saved_row);
+            break;
+
+        default:
+            break;
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void terminal::erase(const int first, const int last)
+{
+    if(first >= last)
+    {
+        return;
+    }
+
+    std::fill(m_cells.begin() + first, m_cells.begin() + last, blank());
+    std::fill(m_dirty.begin() + first / m_columns, m_dirty.begin() + (last - 1) / m_columns + 1, 1u);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void terminal::escape_dispatch(const unsigned char c)
+{
+    m_state = state::ground;
+
+    switch(c)
+    {
+        case '[':
+            m_state = state::csi;
+            m_params[0] = 0;
+            m_num_params = 1;
+            m_private = false;
+            break;
+
+        case ']':
+            m_state = state::osc;
+            break;
+
+        case '(':
+        case ')':
+        case '*':
+        case '+':
+            m_state = state::escape_charset;
+            break;
+
+        case '\\':
+            // string terminator, the end of an operating system command
+            break;
+
+        case '7':
+            m_saved_col = m_col;
+            m_saved_row = m_row;
+            m_saved_attr = m_attr;
+            break;
+
+        case '8':
+            move_to(m_saved_col, m_saved_row);
+            m_attr = m_saved_attr;
+            break;
+
+        case 'D':
+            line_feed();
+            break;
+
+        case 'E':
+            line_feed();
+            m_col = 0;
+            break;
+
+        case 'M':
+            if(m_row == m_top)
+            {
+                scroll_down(m_top, m_bottom, 1);
+            }
+            else
+            {
+                move_to(m_col, m_row - 1);
+            }
+            break;
+
+        case 'c':
+            reset();
+            break;
+
+        default:
+            break;
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void terminal::line_feed()
+{
+    m_wrap_pending = false;
+
+    if(m_row == m_bottom)
+    {
+        scroll_up(m_top, m_bottom, 1);
+    }
+    else if(m_row < m_rows - 1)
+    {
+        ++m_row;
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void terminal::move_to(const int col, const int row)
+{
+    m_col = std::clamp(col, 0, m_columns - 1);
+    m_row = std::clamp(row, 0, m_rows - 1);
+    m_wrap_pending = false;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+int terminal::param(const std::size_t i, const int fallback) const noexcept
+{
+    return (i < m_num_params && m_params[i] != 0) ? m_params[i] : fallback;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void terminal::put(const int glyph)
+{
+    if(m_wrap_pending)
+    {
+        line_feed();
+        m_col = 0;
+    }
+
+    auto c = blank();
+    c.glyph = glyph;
+    m_cells[static_cast<std::size_t>(m_row * m_columns + m_col)] = c;
+    m_dirty[static_cast<std::size_t>(m_row)] = 1u;
+
+    if(m_col == m_columns - 1)
+    {
+        m_wrap_pending = true;
+    }
+    else
+    {
+        ++m_col;
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void terminal::scroll_down(const int top, const int bottom, const int lines)
+{
+    const auto n = std::clamp(lines, 0, bottom - top + 1);
+    const auto first = m_cells.begin() + top * m_columns;
+    const auto last = m_cells.begin() + (bottom + 1) * m_columns;
+
+    std::shift_right(first, last, n * m_columns);
+    std::fill_n(first, n * m_columns, blank());
+    std::fill(m_dirty.begin() + top, m_dirty.begin() + bottom + 1, 1u);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void terminal::scroll_up(const int top, const int bottom, const int lines)
+{
+    const auto n = std::clamp(lines, 0, bottom - top + 1);
+    const auto first = m_cells.begin() + top * m_columns;
+    const auto last = m_cells.begin() + (bottom + 1) * m_columns;
+
+    std::shift_left(first, last, n * m_columns);
+    std::fill(last - n * m_columns, last, blank());
+    std::fill(m_dirty.begin() + top, m_dirty.begin() + bottom + 1, 1u);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void terminal::select_graphic_rendition()
+{
+    for(const auto i : std::views::iota(std::size_t{0}, m_num_params))
+    {
+        const auto p = m_params[i];
+
+        if(p == 0)
+        {
+            m_attr = {};
+        }
+        else if(p == 1)
+        {
+            m_attr.bold = true;
+        }
+        else if(p == 22)
+        {
+            m_attr.bold = false;
+        }
+        else if(p == 7)
+        {
+            m_attr.reverse = true;
+        }
+        else if(p == 27)
+        {
+            m_attr.reverse = false;
+        }
+        else if(p >= 30 && p <= 37)
+        {
+            m_attr.fg = ansi_colors[static_cast<std::size_t>(p - 30)];
+        }
+        else if(p == 39)
+        {
+            m_attr.fg = attributes{}.fg;
+        }
+        else if(p >= 40 && p <= 47)
+        {
+            m_attr.bg = ansi_colors[static_cast<std::size_t>(p - 40)];
+        }
+        else if(p == 49)
+        {
+            m_attr.bg = attributes{}.bg;
+        }
+        else if(p >= 90 && p <= 97)
+        {
+            m_attr.fg = ansi_colors[static_cast<std::size_t>(p - 90)] + 8;
+        }
+        else if(p >= 100 && p <= 107)
+        {
+            m_attr.bg = ansi_colors[static_cast<std::size_t>(p - 100)] + 8;
+        }
+    }
+}
+
+}   // retro
@@ -0,0 +1,269 @@
+////////////////////////////////////////////////////////////////////////////////
+// Retro - Retro Computing Library
+// Copyright (c) 2023 Ryan Clarke
+////////////////////////////////////////////////////////////////////////////////
+
+#include "retro/trace.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+
+////////////////////////////////////////////////////////////////////////////////
+namespace
+{
+
+////////////////////////////////////////////////////////////////////////////////
+using clock = std::chrono::steady_clock;
+
+constexpr std::size_t ring_size{16384};         // zones held per thread
+
+
+////////////////////////////////////////////////////////////////////////////////
+struct event
+{
+    const char* name{};
+    std::uint32_t tid{};
+    clock::time_point start;
+    clock::duration duration{};
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// \brief Ring of zones written by a single thread. The reader copies the
+/// ring without locking and keeps only the zones the writer cannot have
+/// overwritten while it was copying.
+////////////////////////////////////////////////////////////////////////////////
+struct ring
+{
+    std::vector<event> events = std::vector<event>(ring_size);
+    std::atomic<std::uint64_t> head{0};         // zones written
+    std::atomic<std::uint64_t> first{0};        // first zone not cleared
+    bool in_use{false};
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// \brief Rings of all threads. Rings outlive their threads so their zones
+/// can still be written out, and are reused by new threads.
+////////////////////////////////////////////////////////////////////////////////
+struct registry
+{
+    std::mutex mutex;
+    std::vector<std::unique_ptr<ring>> rings;
+    std::atomic<std::uint32_t> next_tid{1};
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+registry& get_registry()
+{
+    static registry r;
+    return r;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// \brief Ring of the calling thread, taken on its first zone and released
+/// when the thread exits.
+////////////////////////////////////////////////////////////////////////////////
+class thread_ring
+{
+  public:
+    thread_ring()
+        : m_tid{get_registry().next_tid.fetch_add(1, std::memory_order_relaxed)}
+    {
+        auto& r = get_registry();
+        const std::scoped_lock lock{r.mutex};
+
+        const auto free = std::ranges::find_if(r.rings, [](const auto& p) { return !p->in_use; });
+        m_ring = (free != r.rings.end()) ? free->get() : r.rings.emplace_back(std::make_unique<ring>()).get();
+        m_ring->in_use = true;
+    }
+
+    ~thread_ring()
+    {
+        const std::scoped_lock lock{get_registry().mutex};
+        m_ring->in_use = false;
+    }
+
+    thread_ring(const thread_ring&) = delete;
+    thread_ring& operator=(const thread_ring&) = delete;
+
+    void record(const char* name, const clock::time_point start, const clock::time_point end) noexcept
+    {
+        const auto head = m_ring->head.load(std::memory_order_relaxed);
+        m_ring->events[head % ring_size] = {name, m_tid, start, end - start};
+        m_ring->head.store(head + 1, std::memory_order_release);
+    }
+
+  private:
+    ring* m_ring{nullptr};
+    std::uint32_t m_tid{};
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// \brief Copy the zones of a ring.
+/// \param r ring
+/// \param out zones, appended
+////////////////////////////////////////////////////////////////////////////////
+void collect(const ring& r, std::vector<event>& out)
+{
+    const auto head = r.head.load(std::memory_order_acquire);
+    const auto begin = std::max(r.first.load(std::memory_order_relaxed), (head > ring_size) ? head - ring_size : 0);
+    const auto size = out.size();
+
+    for(auto i = begin; i < head; ++i)
+    {
+        out.emplace_back(r.events[i % ring_size]);
+    }
+
+    // zones the writer may have overwritten while they were copied are
+    // dropped; the fence keeps the copies above before the second load of the
+    // head, and the slot of zone "now" may be being written before the head
+    // is published, so zone now - ring_size is also dropped
+    std::atomic_thread_fence(std::memory_order_acquire);
+    const auto now = r.head.load(std::memory_order_relaxed);
+    const auto valid = (now + 1 > ring_size) ? std::max(begin, now + 1 - ring_size) : begin;
+    const auto dropped = static_cast<std::ptrdiff_t>(std::min(valid, head) - begin);
+
+    out.erase(out.begin() + static_cast<std::ptrdiff_t>(size), out.begin() + static_cast<std::ptrdiff_t>(size) + dropped);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// \brief Write a string as a JSON string.
+/// \param os output stream
+/// \param s string
+////////////////////////////////////////////////////////////////////////////////
+void write_string(std::ostream& os, const std::string_view s)
+{
+    os << '"';
+
+    for(const auto c : s)
+    {
+        if(c == '"' || c == '\\')
+        {
+            os << '\\';
+        }
+
+        os << ((static_cast<unsigned char>(c) < 0x20u) ? ' ' : c);
+    }
+
+    os << '"';
+}
+
+}   // unnamed
+
+
+////////////////////////////////////////////////////////////////////////////////
+namespace retro::trace
+{
+
+#ifdef RETRO_ENABLE_TRACE
+////////////////////////////////////////////////////////////////////////////////
+zone::zone(const char* name) noexcept
+    : m_name{name},
+      m_start{clock::now()}
+{
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+zone::~zone()
+{
+    thread_local thread_ring ring;
+    ring.record(m_name, m_start, clock::now());
+}
+#endif
+
+
+////////////////////////////////////////////////////////////////////////////////
+void clear() noexcept
+{
+    auto& r = get_registry();
+    const std::scoped_lock lock{r.mutex};
+
+    for(const auto& p : r.rings)
+    {
+        p->first.store(p->head.load(std::memory_order_acquire), std::memory_order_relaxed);
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void save(const std::filesystem::path& path)
+{
+    std::ofstream file{path};
+
+    if(!file)
+    {
+        throw std::runtime_error("trace::save cannot open " + path.string());
+    }
+
+    write(file);
+
+    if(!file)
+    {
+        throw std::runtime_error("trace::save cannot write " + path.string());
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void write(std::ostream& os)
+{
+    std::vector<event> events;
+
+    {
+        auto& r = get_registry();
+        const std::scoped_lock lock{r.mutex};
+
+        for(const auto& p : r.rings)
+        {
+            collect(*p, events);
+        }
+    }
+
+    std::ranges::sort(events, {}, &event::start);
+
+    // timestamps are microseconds from the first zone
+    const auto origin = events.empty() ? clock::time_point{} : events.front().start;
+    const auto micros = [](const clock::duration d) { return std::chrono::duration<double, std::micro>{d}.count(); };
+
+    os << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+    for(const auto& e : events)
+    {
+        if(&e != events.data())
+        {
+            os << ',';
+        }
+
+        std::array<char, 64> times{};
+        std::snprintf(times.data(), times.size(), "\"ts\":%.3f,\"dur\":%.3f", micros(e.start - origin),
+                      micros(e.duration));
+
+        os << "\n{\"name\":";
+        write_string(os, e.name);
+        os << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << e.tid << ',' << times.data() << '}';
+    }
+
+    os << "\n]}\n";
+}
+
+}   // retro::trace
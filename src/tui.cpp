@@ -0,0 +1,792 @@
+////////////////////////////////////////////////////////////////////////////////
+// Retro - Retro Computing Library
+// Copyright (c) 2023 Ryan Clarke
+////////////////////////////////////////////////////////////////////////////////
+
+#include "retro/tui.hpp"
+#include "retro/scrollback.hpp"
+#include "retro/vga.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+
+////////////////////////////////////////////////////////////////////////////////
+namespace
+{
+
+////////////////////////////////////////////////////////////////////////////////
+// CP437 box drawing characters
+struct frame_glyphs
+{
+    int top_left;
+    int top_right;
+    int bottom_left;
+    int bottom_right;
+    int horizontal;
+    int vertical;
+};
+
+constexpr frame_glyphs single_frame{0xda, 0xbf, 0xc0, 0xd9, 0xc4, 0xb3};
+constexpr frame_glyphs double_frame{0xc9, 0xbb, 0xc8, 0xbc, 0xcd, 0xba};
+
+constexpr int vertical_line{0xb3};              // │
+constexpr int horizontal_line{0xc4};            // ─
+constexpr int cross{0xc5};                      // ┼
+
+// a cell that never matches a composed one, forcing it to be drawn
+constexpr retro::text_cell unknown_cell{0xffff, 0, 0};
+
+
+////////////////////////////////////////////////////////////////////////////////
+constexpr retro::text_cell make_cell(const int glyph, const int fg, const int bg) noexcept
+{
+    return {static_cast<std::uint16_t>(glyph), static_cast<std::uint8_t>(fg), static_cast<std::uint8_t>(bg)};
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+constexpr retro::rect intersect(const retro::rect& a, const retro::rect& b) noexcept
+{
+    const auto x0 = std::max(a.x, b.x);
+    const auto y0 = std::max(a.y, b.y);
+    const auto x1 = std::min(a.x + a.width, b.x + b.width);
+    const auto y1 = std::min(a.y + a.height, b.y + b.height);
+
+    return {x0, y0, std::max(x1 - x0, 0), std::max(y1 - y0, 0)};
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// \brief Get the first visible item of a scrolling view.
+/// \param top current first visible item
+/// \param item item to show
+/// \param visible number of visible items
+/// \return first visible item
+////////////////////////////////////////////////////////////////////////////////
+constexpr std::size_t scroll_into_view(const std::size_t top, const std::size_t item, const std::size_t visible) noexcept
+{
+    if(item < top)
+    {
+        return item;
+    }
+
+    if(visible > 0 && item >= top + visible)
+    {
+        return item - visible + 1;
+    }
+
+    return top;
+}
+
+}   // unnamed
+
+
+////////////////////////////////////////////////////////////////////////////////
+namespace retro::tui
+{
+
+////////////////////////////////////////////////////////////////////////////////
+canvas::canvas(const std::span<text_cell> cells, const int columns, const int rows) noexcept
+    : m_cells{cells}, m_pitch{columns}, m_width{columns}, m_height{rows}, m_clip{0, 0, columns, rows}
+{
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void canvas::fill(const rect& area, const text_cell& c) noexcept
+{
+    const auto r = intersect({m_x + area.x, m_y + area.y, area.width, area.height}, m_clip);
+
+    for(const auto y : std::views::iota(r.y, r.y + r.height))
+    {
+        const auto row = m_cells.begin() + static_cast<std::ptrdiff_t>(y * m_pitch + r.x);
+        std::fill_n(row, r.width, c);
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void canvas::frame(const rect& area, const frame_style frame, const int fg, const int bg) noexcept
+{
+    if(frame == frame_style::none || area.width < 2 || area.height < 2)
+    {
+        return;
+    }
+
+    const auto& g = (frame == frame_style::single) ? single_frame : double_frame;
+    const auto x1 = area.x + area.width - 1;
+    const auto y1 = area.y + area.height - 1;
+
+    fill({area.x + 1, area.y, area.width - 2, 1}, make_cell(g.horizontal, fg, bg));
+    fill({area.x + 1, y1, area.width - 2, 1}, make_cell(g.horizontal, fg, bg));
+    fill({area.x, area.y + 1, 1, area.height - 2}, make_cell(g.vertical, fg, bg));
+    fill({x1, area.y + 1, 1, area.height - 2}, make_cell(g.vertical, fg, bg));
+
+    put(area.x, area.y, make_cell(g.top_left, fg, bg));
+    put(x1, area.y, make_cell(g.top_right, fg, bg));
+    put(area.x, y1, make_cell(g.bottom_left, fg, bg));
+    put(x1, y1, make_cell(g.bottom_right, fg, bg));
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+int canvas::height() const noexcept
+{
+    return m_height;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void canvas::put(const int x, const int y, const text_cell& c) noexcept
+{
+    const auto gx = m_x + x;
+    const auto gy = m_y + y;
+
+    if(gx >= m_clip.x && gx < m_clip.x + m_clip.width && gy >= m_clip.y && gy < m_clip.y + m_clip.height)
+    {
+        m_cells[static_cast<std::size_t>(gy * m_pitch + gx)] = c;
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+canvas canvas::sub(const rect& area) const noexcept
+{
+    auto c = *this;
+    c.m_x = m_x + area.x;
+    c.m_y = m_y + area.y;
+    c.m_width = area.width;
+    c.m_height = area.height;
+    c.m_clip = intersect(m_clip, {c.m_x, c.m_y, area.width, area.height});
+
+    return c;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void canvas::text(const int x, const int y, const std::string_view s, const int fg, const int bg, const int width) noexcept
+{
+    const auto n = std::max(static_cast<int>(s.size()), width);
+
+    for(const auto i : std::views::iota(0, n))
+    {
+        const auto glyph = (i < std::ssize(s)) ? static_cast<unsigned char>(s[static_cast<std::size_t>(i)]) : ' ';
+        put(x + i, y, make_cell(glyph, fg, bg));
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+int canvas::width() const noexcept
+{
+    return m_width;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+widget::widget(const rect& bounds)
+    : m_bounds{bounds}
+{
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+const rect& widget::bounds() const noexcept
+{
+    return m_bounds;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void widget::move(const rect& bounds) noexcept
+{
+    m_bounds = bounds;
+    invalidate();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+bool widget::on_char(char)
+{
+    return false;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+bool widget::on_key(key)
+{
+    return false;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void widget::set_style(const style& s) noexcept
+{
+    m_style = s;
+    invalidate();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void widget::set_visible(const bool visible) noexcept
+{
+    m_visible = visible;
+    invalidate();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+rect widget::client() const noexcept
+{
+    return {0, 0, m_bounds.width, m_bounds.height};
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void widget::invalidate() noexcept
+{
+    m_changed = true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+bool widget::take_changed() noexcept
+{
+    auto changed = std::exchange(m_changed, false);
+
+    for(const auto& child : m_children)
+    {
+        changed |= child->take_changed();
+    }
+
+    return changed;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void widget::render(const canvas& c, const widget* focus) const
+{
+    if(!m_visible)
+    {
+        return;
+    }
+
+    auto area = c.sub(m_bounds);
+    draw(area, this == focus);
+
+    const auto inner = area.sub(client());
+
+    for(const auto& child : m_children)
+    {
+        child->render(inner, focus);
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+window::window(const rect& bounds, std::string title, const frame_style frame)
+    : widget{bounds}, m_title{std::move(title)}, m_frame{frame}
+{
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void window::set_title(std::string title)
+{
+    m_title = std::move(title);
+    invalidate();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+rect window::client() const noexcept
+{
+    const auto& b = bounds();
+
+    if(m_frame == frame_style::none)
+    {
+        return {0, 0, b.width, b.height};
+    }
+
+    return {1, 1, b.width - 2, b.height - 2};
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void window::draw(canvas& c, bool) const
+{
+    c.fill({0, 0, c.width(), c.height()}, make_cell(' ', m_style.fg, m_style.bg));
+    c.frame({0, 0, c.width(), c.height()}, m_frame, m_style.fg, m_style.bg);
+
+    if(m_frame != frame_style::none && !m_title.empty())
+    {
+        // the title sits in the top edge, padded by a space on each side
+        const auto length = std::min(static_cast<int>(m_title.size()), c.width() - 6);
+        c.text(2, 0, " ", m_style.fg, m_style.bg);
+        c.text(3, 0, std::string_view{m_title}.substr(0, static_cast<std::size_t>(std::max(length, 0))),
+               m_style.fg, m_style.bg);
+        c.text(3 + std::max(length, 0), 0, " ", m_style.fg, m_style.bg);
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+label::label(const rect& bounds, std::string text)
+    : widget{bounds}, m_text{std::move(text)}
+{
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void label::set_text(std::string text)
+{
+    if(text != m_text)
+    {
+        m_text = std::move(text);
+        invalidate();
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void label::draw(canvas& c, bool) const
+{
+    c.text(0, 0, m_text, m_style.fg, m_style.bg, c.width());
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+list::list(const rect& bounds, std::vector<std::string> items)
+    : widget{bounds}, m_items{std::move(items)}
+{
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+bool list::on_key(const key k)
+{
+    const auto page = static_cast<std::size_t>(std::max(bounds().height, 1));
+
+    switch(k)
+    {
+        case key::up:
+            select((m_selected > 0) ? m_selected - 1 : 0);
+            return true;
+
+        case key::down:
+            select(m_selected + 1);
+            return true;
+
+        case key::page_up:
+            select((m_selected > page) ? m_selected - page : 0);
+            return true;
+
+        case key::page_down:
+            select(m_selected + page);
+            return true;
+
+        case key::home:
+            select(0);
+            return true;
+
+        case key::end:
+            select(m_items.size());
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+std::size_t list::selected() const noexcept
+{
+    return m_selected;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void list::set_items(std::vector<std::string> items)
+{
+    m_items = std::move(items);
+    m_top = 0;
+    select(m_selected);
+    invalidate();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void list::select(const std::size_t index)
+{
+    const auto selected = m_items.empty() ? 0 : std::min(index, m_items.size() - 1);
+    const auto top = scroll_into_view(m_top, selected, static_cast<std::size_t>(std::max(bounds().height, 0)));
+
+    if(selected != m_selected || top != m_top)
+    {
+        m_selected = selected;
+        m_top = top;
+        invalidate();
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void list::draw(canvas& c, const bool focused) const
+{
+    for(const auto row : std::views::iota(0, c.height()))
+    {
+        const auto i = m_top + static_cast<std::size_t>(row);
+        const auto highlight = (i == m_selected && focused);
+        const auto fg = highlight ? m_style.select_fg : m_style.fg;
+        const auto bg = highlight ? m_style.select_bg : m_style.bg;
+
+        c.text(0, row, (i < m_items.size()) ? std::string_view{m_items[i]} : std::string_view{}, fg, bg, c.width());
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+table::table(const rect& bounds, std::vector<column> columns)
+    : widget{bounds}, m_columns{std::move(columns)}
+{
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void table::add_row(std::vector<std::string> cells)
+{
+    cells.resize(m_columns.size());
+    m_rows.push_back(std::move(cells));
+    invalidate();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void table::clear_rows() noexcept
+{
+    m_rows.clear();
+    m_top = 0;
+    invalidate();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+bool table::on_key(const key k)
+{
+    // the header takes two rows
+    const auto visible = static_cast<std::size_t>(std::max(bounds().height - 2, 1));
+    const auto last = (m_rows.size() > visible) ? m_rows.size() - visible : 0;
+    auto top = m_top;
+
+    switch(k)
+    {
+        case key::up:
+            top = (top > 0) ? top - 1 : 0;
+            break;
+
+        case key::down:
+            top = std::min(top + 1, last);
+            break;
+
+        case key::page_up:
+            top = (top > visible) ? top - visible : 0;
+            break;
+
+        case key::page_down:
+            top = std::min(top + visible, last);
+            break;
+
+        case key::home:
+            top = 0;
+            break;
+
+        case key::end:
+            top = last;
+            break;
+
+        default:
+            return false;
+    }
+
+    if(top != m_top)
+    {
+        m_top = top;
+        invalidate();
+    }
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void table::set_cell(const std::size_t row, const std::size_t col, std::string text)
+{
+    if(row >= m_rows.size() || col >= m_columns.size())
+    {
+        throw std::invalid_argument("table::set_cell has an invalid argument");
+    }
+
+    if(auto& cell = m_rows[row][col]; cell != text)
+    {
+        cell = std::move(text);
+        invalidate();
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void table::draw(canvas& c, bool) const
+{
+    const auto fg = m_style.fg;
+    const auto bg = m_style.bg;
+
+    c.fill({0, 0, c.width(), c.height()}, make_cell(' ', fg, bg));
+    c.fill({0, 1, c.width(), 1}, make_cell(horizontal_line, fg, bg));
+
+    auto x = 0;
+
+    for(const auto i : std::views::iota(std::size_t{0}, m_columns.size()))
+    {
+        const auto& col = m_columns[i];
+        auto column = c.sub({x, 0, col.width, c.height()});
+        column.text(0, 0, col.title, fg, bg);
+
+        for(const auto row : std::views::iota(2, c.height()))
+        {
+            const auto r = m_top + static_cast<std::size_t>(row - 2);
+
+            if(r < m_rows.size())
+            {
+                column.text(0, row, m_rows[r][i], fg, bg);
+            }
+        }
+
+        x += col.width;
+
+        // separator between columns
+        if(i + 1 < m_columns.size())
+        {
+            c.fill({x, 0, 1, c.height()}, make_cell(vertical_line, fg, bg));
+            c.put(x, 1, make_cell(cross, fg, bg));
+            ++x;
+        }
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+input_field::input_field(const rect& bounds, const std::size_t max_length)
+    : widget{bounds}, m_max_length{max_length}
+{
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+bool input_field::on_char(const char c)
+{
+    const auto byte = static_cast<unsigned char>(c);
+
+    if(byte < 0x20 || byte == 0x7f)
+    {
+        return false;
+    }
+
+    if(m_text.size() < m_max_length)
+    {
+        m_text.insert(m_cursor, 1, c);
+        ++m_cursor;
+        scroll_to_cursor();
+        invalidate();
+    }
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+bool input_field::on_key(const key k)
+{
+    switch(k)
+    {
+        case key::left:
+            m_cursor -= (m_cursor > 0) ? 1 : 0;
+            break;
+
+        case key::right:
+            m_cursor += (m_cursor < m_text.size()) ? 1 : 0;
+            break;
+
+        case key::home:
+            m_cursor = 0;
+            break;
+
+        case key::end:
+            m_cursor = m_text.size();
+            break;
+
+        case key::backspace:
+            if(m_cursor > 0)
+            {
+                m_text.erase(--m_cursor, 1);
+            }
+            break;
+
+        case key::del:
+            if(m_cursor < m_text.size())
+            {
+                m_text.erase(m_cursor, 1);
+            }
+            break;
+
+        default:
+            return false;
+    }
+
+    scroll_to_cursor();
+    invalidate();
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void input_field::set_text(std::string text)
+{
+    m_text = std::move(text);
+    m_text.resize(std::min(m_text.size(), m_max_length));
+    m_cursor = m_text.size();
+    scroll_to_cursor();
+    invalidate();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+const std::string& input_field::text() const noexcept
+{
+    return m_text;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void input_field::draw(canvas& c, const bool focused) const
+{
+    const auto visible = std::string_view{m_text}.substr(std::min(m_scroll, m_text.size()));
+    c.text(0, 0, visible, m_style.fg, m_style.bg, c.width());
+
+    // the cursor is the cell under it in the selection colors
+    if(focused)
+    {
+        const auto at = m_cursor - m_scroll;
+        const auto glyph = (m_cursor < m_text.size()) ? static_cast<unsigned char>(m_text[m_cursor]) : ' ';
+        c.put(static_cast<int>(at), 0, make_cell(glyph, m_style.select_fg, m_style.select_bg));
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void input_field::scroll_to_cursor() noexcept
+{
+    m_scroll = scroll_into_view(m_scroll, m_cursor, static_cast<std::size_t>(std::max(bounds().width, 0)));
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+screen::screen(vga& display, const text_cell& background)
+    : m_vga{display}, m_background{background}
+{
+    std::tie(m_columns, m_rows) = m_vga.get_text_size();
+
+    const auto size = static_cast<std::size_t>(m_columns * m_rows);
+    m_back.assign(size, m_background);
+    m_front.assign(size, unknown_cell);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void screen::invalidate() noexcept
+{
+    std::ranges::fill(m_front, unknown_cell);
+    m_changed = true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+bool screen::on_char(const char c)
+{
+    return (m_focus != nullptr) && m_focus->on_char(c);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+bool screen::on_key(const key k)
+{
+    return (m_focus != nullptr) && m_focus->on_key(k);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+std::size_t screen::render()
+{
+    auto changed = std::exchange(m_changed, false);
+
+    for(const auto& w : m_widgets)
+    {
+        changed |= w->take_changed();
+    }
+
+    if(!changed)
+    {
+        return 0;
+    }
+
+    std::ranges::fill(m_back, m_background);
+
+    const canvas c{m_back, m_columns, m_rows};
+
+    for(const auto& w : m_widgets)
+    {
+        w->render(c, m_focus);
+    }
+
+    // only the cells that differ from the frame on screen are drawn
+    std::size_t drawn{0};
+
+    for(const auto i : std::views::iota(std::size_t{0}, m_back.size()))
+    {
+        if(const auto& cell = m_back[i]; cell != m_front[i])
+        {
+            const auto col = static_cast<int>(i) % m_columns;
+            const auto row = static_cast<int>(i) / m_columns;
+            m_vga.put_glyph(col, row, cell.glyph, cell.fg, cell.bg);
+            ++drawn;
+        }
+    }
+
+    std::swap(m_back, m_front);
+
+    return drawn;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void screen::set_focus(widget* w) noexcept
+{
+    if(w != m_focus)
+    {
+        m_focus = w;
+        m_changed = true;
+    }
+}
+
+}   // retro::tui
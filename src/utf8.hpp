@@ -0,0 +1,111 @@
+////////////////////////////////////////////////////////////////////////////////
+// Retro - Retro Computing Library
+// Copyright (c) 2023 Ryan Clarke
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef RETRO_UTF8_HPP
+#define RETRO_UTF8_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <utility>
+
+
+////////////////////////////////////////////////////////////////////////////////
+namespace retro::detail
+{
+
+////////////////////////////////////////////////////////////////////////////////
+inline constexpr char32_t replacement_character{U'\xfffd'};
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// \brief Count the ASCII bytes at the start of a string. Bytes are tested 16
+/// at a time, two 64 bit words per step, until a word has a high bit set.
+/// \param s UTF-8 string
+/// \return length of the ASCII prefix
+////////////////////////////////////////////////////////////////////////////////
+[[nodiscard]] inline std::size_t ascii_prefix(const std::u8string_view s) noexcept
+{
+    constexpr std::uint64_t high_bits{0x8080808080808080u};
+
+    std::size_t n{0};
+
+    for(; n + 16 <= s.size(); n += 16)
+    {
+        std::uint64_t lo{};
+        std::uint64_t hi{};
+        std::memcpy(&lo, s.data() + n, sizeof(lo));
+        std::memcpy(&hi, s.data() + n + 8, sizeof(hi));
+
+        if(((lo | hi) & high_bits) != 0u)
+        {
+            break;
+        }
+    }
+
+    while(n < s.size() && s[n] < 0x80)
+    {
+        ++n;
+    }
+
+    return n;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// \brief Decode one code point. Malformed, overlong and surrogate sequences
+/// decode to U+FFFD, consuming one byte.
+/// \param s UTF-8 string, not empty
+/// \return code point and length of its sequence
+////////////////////////////////////////////////////////////////////////////////
+[[nodiscard]] constexpr std::pair<char32_t, std::size_t> decode(const std::u8string_view s) noexcept
+{
+    const auto lead = static_cast<char32_t>(s[0]);
+
+    if(lead < 0x80)
+    {
+        return {lead, 1};
+    }
+
+    // sequence length, and the smallest code point it may encode
+    const auto [length, min] = (lead >= 0xc2 && lead <= 0xdf) ? std::pair{1uz, U'\x80'} :
+                               (lead >= 0xe0 && lead <= 0xef) ? std::pair{2uz, U'\x800'} :
+                               (lead >= 0xf0 && lead <= 0xf4) ? std::pair{3uz, U'\x10000'} :
+                                                                std::pair{0uz, U'\0'};
+
+    if(length == 0 || s.size() <= length)
+    {
+        return {replacement_character, 1};
+    }
+
+    auto c = lead & (0x3fu >> length);
+
+    for(const auto b : s.substr(1, length))
+    {
+        if((b & 0xc0) != 0x80)
+        {
+            return {replacement_character, 1};
+        }
+
+        c = (c << 6) | (static_cast<char32_t>(b) & 0x3fu);
+    }
+
+    if(c < min || c > 0x10ffff || (c >= 0xd800 && c <= 0xdfff))
+    {
+        return {replacement_character, 1};
+    }
+
+    return {c, length + 1};
+}
+
+static_assert(decode(u8"é") == std::pair{U'é', 2uz});
+static_assert(decode(u8"\U0001f600") == std::pair{U'\U0001f600', 4uz});
+static_assert(decode(u8"\xc0\x80").first == replacement_character);
+
+}   // retro::detail
+
+
+#endif  // RETRO_UTF8_HPP
@@ -3,20 +3,42 @@
 // Copyright (c) 2023 Ryan Clarke
 ////////////////////////////////////////////////////////////////////////////////
 
+#include "retro/atlas.hpp"
 #include "retro/color.hpp"
+#include "retro/compiled_sprite.hpp"
+#include "retro/scrollback.hpp"
 #include "retro/sprite.hpp"
+#include "retro/sprite_batch.hpp"
+#include "retro/trace.hpp"
 #include "retro/vga.hpp"
 
+#include "glyphs.hpp"
+#include "raster_op.hpp"
+#include "stats.hpp"
+#include "utf8.hpp"
+#include "worker_pool.hpp"
+
 #include <SDL2/SDL.h>
 
 #include <algorithm>
 #include <array>
+#include <chrono>
+#include <cmath>
 #include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
 #include <map>
+#include <memory>
+#include <optional>
 #include <ranges>
 #include <span>
 #include <stdexcept>
 #include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 
@@ -47,14 +69,11 @@ constexpr std::array<retro::color, 16> ega_palette
 
 
 ////////////////////////////////////////////////////////////////////////////////
-extern "C" const std::array<std::byte, 8 * 256> glyphs_8x8;
-extern "C" const std::array<std::byte, 14 * 256> glyphs_8x14;
-extern "C" const std::array<std::byte, 16 * 256> glyphs_8x16;
-
-const retro::font vga_8x8{glyphs_8x8, 8, 8};
-const retro::font ega_8x14{glyphs_8x14, 8, 14};
-const retro::font vga_8x16{glyphs_8x16, 8, 16};
-const retro::font vga_9x16{glyphs_8x16, 9, 16};     // uses 8x16 glyphs
+// the built-in fonts view the glyph tables, so they need no dynamic initialization
+constinit const retro::font vga_8x8{retro::font::borrow, retro::detail::glyphs_8x8, 8, 8};
+constinit const retro::font ega_8x14{retro::font::borrow, retro::detail::glyphs_8x14, 8, 14};
+constinit const retro::font vga_8x16{retro::font::borrow, retro::detail::glyphs_8x16, 8, 16};
+constinit const retro::font vga_9x16{retro::font::borrow, retro::detail::glyphs_8x16, 8, 16, 1};   // 9th column blank
 
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -85,31 +104,195 @@ const std::map<retro::vga::mode, const vga_mode&> vga_modes
     {retro::vga::mode::vga_13h, vga_13h}
 };
 
-}   // unnamed
+
+////////////////////////////////////////////////////////////////////////////////
+// more changed rectangles than this are converted as a full frame
+constexpr std::size_t max_dirty_rects{64};
 
 
 ////////////////////////////////////////////////////////////////////////////////
-namespace retro
+// performance overlay layout, in 8x8 character cells
+constexpr int hud_columns{24};
+constexpr int hud_lines{4};
+constexpr int hud_margin{2};
+constexpr int hud_width{hud_columns * 8 + 2 * hud_margin};
+constexpr int hud_height{hud_lines * 8 + 2 * hud_margin};
+constexpr std::uint32_t hud_background{0xff000000u};
+constexpr std::uint32_t hud_foreground{0xffffff55u};
+
+
+////////////////////////////////////////////////////////////////////////////////
+struct clip_rect
 {
+    int src_x{};
+    int src_y{};
+    int dst_x{};
+    int dst_y{};
+    int width{};
+    int height{};
+};
 
+
+////////////////////////////////////////////////////////////////////////////////
+/// \brief Clip a rectangle to a bounding rectangle.
+/// \param x x location of the rectangle
+/// \param y y location of the rectangle
+/// \param width width of the rectangle
+/// \param height height of the rectangle
+/// \param bounds bounding rectangle, usually the screen
+/// \return visible part of the rectangle, or std::nullopt if out of bounds
 ////////////////////////////////////////////////////////////////////////////////
-vga::vga(const mode video_mode)
+[[nodiscard]] std::optional<clip_rect> clip(const int x, const int y, const int width, const int height,
+                                            const retro::rect& bounds) noexcept
 {
-    SDL_CreateWindowAndRenderer(0, 0, SDL_WINDOW_FULLSCREEN_DESKTOP, &m_window, &m_renderer);
+    const auto x0 = std::max(bounds.x, x);
+    const auto y0 = std::max(bounds.y, y);
+    const auto x1 = std::min(bounds.x + bounds.width, x + width);
+    const auto y1 = std::min(bounds.y + bounds.height, y + height);
 
-    if(m_window == nullptr || m_renderer == nullptr)
+    if(x0 >= x1 || y0 >= y1)
     {
-        throw std::runtime_error(SDL_GetError());
+        return std::nullopt;
+    }
+
+    return clip_rect{x0 - x, y0 - y, x0, y0, x1 - x0, y1 - y0};
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// \brief Move the rows of a rectangle within a buffer, filling the rows
+/// moved away from.
+/// \param buffer buffer
+/// \param pitch width of the buffer
+/// \param area rectangle within the buffer
+/// \param lines number of rows, up if positive and down if negative
+/// \param fill value of the rows moved away from
+////////////////////////////////////////////////////////////////////////////////
+template<typename T>
+void shift_rows(std::vector<T>& buffer, const int pitch, const clip_rect& area, const int lines, const T& fill)
+{
+    const auto n = std::min(std::abs(lines), area.height);
+    const auto row = [&](const int y)
+    {
+        return buffer.begin() + (area.dst_x + static_cast<std::ptrdiff_t>(area.dst_y + y) * pitch);
+    };
+
+    if(lines > 0)
+    {
+        for(auto y = 0; y < area.height - n; ++y)
+        {
+            std::copy_n(row(y + n), area.width, row(y));
+        }
+
+        for(auto y = area.height - n; y < area.height; ++y)
+        {
+            std::fill_n(row(y), area.width, fill);
+        }
+    }
+    else
+    {
+        for(auto y = area.height - 1; y >= n; --y)
+        {
+            std::copy_n(row(y - n), area.width, row(y));
+        }
+
+        for(auto y = 0; y < n; ++y)
+        {
+            std::fill_n(row(y), area.width, fill);
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// \brief Floor division of signed integers.
+////////////////////////////////////////////////////////////////////////////////
+[[nodiscard]] constexpr std::int64_t floor_div(const std::int64_t a, const std::int64_t b) noexcept
+{
+    const auto q = a / b;
+    return ((a % b) != 0 && ((a < 0) != (b < 0))) ? q - 1 : q;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// \brief Find the steps k in [first, last) for which the fixed-point value
+/// u + du * k lies in [0, limit).
+/// \param u starting value
+/// \param du step
+/// \param limit exclusive upper limit
+/// \param first first step
+/// \param last last step (exclusive)
+/// \return range of steps [first, last)
+////////////////////////////////////////////////////////////////////////////////
+[[nodiscard]] constexpr std::pair<std::int64_t, std::int64_t>
+    step_range(const std::int64_t u, const std::int64_t du, const std::int64_t limit,
+               std::int64_t first, std::int64_t last) noexcept
+{
+    if(du == 0)
+    {
+        return (u >= 0 && u < limit) ? std::pair{first, last} : std::pair{first, first};
+    }
+
+    if(du > 0)
+    {
+        first = std::max(first, -floor_div(u, du));                 // ceil(-u / du)
+        last = std::min(last, floor_div(limit - 1 - u, du) + 1);
+    }
+    else
+    {
+        first = std::max(first, -floor_div(limit - 1 - u, -du));    // ceil((u - limit + 1) / -du)
+        last = std::min(last, floor_div(u, -du) + 1);
+    }
+
+    return {first, std::max(first, last)};
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// \brief Set vertical sync of a renderer.
+/// \param renderer SDL renderer
+/// \param mode vertical sync mode
+////////////////////////////////////////////////////////////////////////////////
+void set_renderer_vsync(SDL_Renderer* const renderer, const retro::vga::vsync mode)
+{
+    // SDL2 itself rejects -1; only an SDL that passes it through to the
+    // driver enables adaptive sync
+    if(mode == retro::vga::vsync::adaptive && SDL_RenderSetVSync(renderer, -1) == 0)
+    {
+        return;
     }
 
+    // failure leaves the renderer unsynced, paced by the caller
+    SDL_RenderSetVSync(renderer, (mode == retro::vga::vsync::off) ? 0 : 1);
+}
+
+}   // unnamed
+
+
+////////////////////////////////////////////////////////////////////////////////
+namespace retro
+{
+
+////////////////////////////////////////////////////////////////////////////////
+vga::vga(const mode video_mode, const init policy)
+{
     set_mode(video_mode);
     reset_palette();
+
+    if(policy == init::immediate)
+    {
+        create_display();
+    }
 }
 
 
 ////////////////////////////////////////////////////////////////////////////////
 vga::~vga()
 {
+    for(auto& [video_mode, buffers] : m_mode_cache)
+    {
+        SDL_DestroyTexture(buffers.texture);
+    }
+
     SDL_DestroyTexture(m_texture);
     SDL_DestroyRenderer(m_renderer);
     SDL_DestroyWindow(m_window);
@@ -123,60 +306,342 @@ vga::~vga()
 ////////////////////////////////////////////////////////////////////////////////
 void vga::blit(const std::span<const int> source)
 {
+    const trace::zone zone{"vga::blit"};
     if(source.size() > m_vram.size())
     {
         throw std::invalid_argument("vga::blit has an invalid argument");
     }
 
     std::ranges::copy(source, m_vram.begin());
+    m_vram_dirty = true;
+    count(&frame_stats::blits);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void vga::blit(const sprite& source, const raster_op op)
+{
+    const trace::zone zone{"vga::blit"};
+    const auto [x, y] = source.position();
+    const auto [width, height] = source.size();
+    const auto& pixels = source.pixels();
+
+    if(pixels.size() > m_vram.size() || std::ssize(pixels) < width * height)
+    {
+        throw std::invalid_argument("vga::blit has an invalid argument");
+    }
+
+    if(blit_pixels(pixels, width, {0, 0, width, height}, x, y, source.color_key(), {0, 0, m_width, m_height}, op))
+    {
+        m_vram_dirty = true;
+    }
+
+    count(&frame_stats::blits);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void vga::blit(const atlas& source, const rect& frame, const int x, const int y, const raster_op op)
+{
+    const trace::zone zone{"vga::blit"};
+    const auto [width, height] = source.size();
+
+    if(frame.x < 0 || frame.y < 0 || frame.width < 0 || frame.height < 0 ||
+       frame.x + frame.width > width || frame.y + frame.height > height)
+    {
+        throw std::invalid_argument("vga::blit has an invalid argument");
+    }
+
+    if(blit_pixels(source.pixels(), width, frame, x, y, source.color_key(), {0, 0, m_width, m_height}, op))
+    {
+        m_vram_dirty = true;
+    }
+
+    count(&frame_stats::blits);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void vga::blit(const atlas& source, const std::string_view frame, const int x, const int y,
+               const raster_op op)
+{
+    blit(source, source.frame(frame), x, y, op);
 }
 
 
 ////////////////////////////////////////////////////////////////////////////////
-void vga::blit(const sprite& source)
+void vga::blit(const compiled_sprite& source, const raster_op op)
 {
-    const auto [x0, y0] = source.position();
+    const trace::zone zone{"vga::blit"};
+    const auto [x, y] = source.position();
     const auto [width, height] = source.size();
 
+    const auto r = clip(x, y, width, height, {0, 0, m_width, m_height});
+    count(&frame_stats::blits);
+
     // sprite completely out of bounds
-    if((x0 + width) < 0 || x0 >= m_width || (y0 + height) < 0 || y0 >= m_height)
+    if(!r.has_value())
     {
         return;
     }
 
     const auto pixels = source.pixels();
+    const auto mask = m_num_colors - 1;
+    m_vram_dirty = true;
+
+    detail::dispatch(op, [&]<raster_op Op>(std::integral_constant<raster_op, Op>)
+    {
+        for(const auto line : std::views::iota(r->src_y, r->src_y + r->height))
+        {
+            const auto row = m_vram.begin() + static_cast<std::ptrdiff_t>(xy_to_index(0, y + line));
+            auto run_x = x;
+
+            for(const auto& run : source.runs(line))
+            {
+                run_x += run.skip;
+
+                // clip the run to the screen
+                const auto x0 = std::max(run_x, 0);
+                const auto x1 = std::min(run_x + run.count, m_width);
+                run_x += run.count;
+
+                if(x0 >= x1)
+                {
+                    if(x0 >= m_width)
+                    {
+                        break;
+                    }
+
+                    continue;
+                }
+
+                const auto p = pixels.subspan(run.data + static_cast<std::size_t>(x0 - (run_x - run.count)),
+                                              static_cast<std::size_t>(x1 - x0));
+                detail::rop_copy<Op>(p, row + x0, mask);
+            }
+        }
+    });
+}
+
 
-    if(pixels.size() > m_vram.size())
+////////////////////////////////////////////////////////////////////////////////
+void vga::blit(const sprite_batch& batch, const int bands)
+{
+    const trace::zone zone{"vga::blit"};
+    if(bands < 1)
     {
         throw std::invalid_argument("vga::blit has an invalid argument");
     }
 
-    // bounding box and on-screen adjusted coordinates
-    const auto l0 = std::max(0, -y0);                   // first visible line
-    const auto l1 = std::min(height, m_height - y0);    // last visible line
-    const auto w0 = std::max(0, -x0);                   // line start
-    const auto w1 = std::min(width - w0, m_width - x0); // line end
-    const auto x1 = std::max(0, x0);                    // adjust on-screen x
-    const auto y1 = std::max(0, y0);                    // adjust on-screen y
+    const auto entries = batch.entries();
+    const rect screen{0, 0, m_width, m_height};
 
-    for(const auto line : std::views::iota(l0, l1))
+    // cull off-screen entries
+    m_batch_order.clear();
+
+    for(const auto i : std::views::iota(std::size_t{0}, entries.size()))
+    {
+        const auto& e = entries[i];
+
+        if(clip(e.x, e.y, e.source.width, e.source.height, screen).has_value())
+        {
+            m_batch_order.emplace_back(i);
+        }
+    }
+
+    count(&frame_stats::blits, m_batch_order.size());
+
+    // the band workers share VRAM, so it is marked changed before they start
+    if(!m_batch_order.empty())
+    {
+        m_vram_dirty = true;
+    }
+
+    // sort by z, then by source image for locality
+    std::ranges::stable_sort(m_batch_order, [&](const std::size_t a, const std::size_t b)
+    {
+        const auto& ea = entries[a];
+        const auto& eb = entries[b];
+
+        if(ea.z != eb.z)
+        {
+            return ea.z < eb.z;
+        }
+
+        return std::less<>{}(ea.pixels.data(), eb.pixels.data());
+    });
+
+    // rasterize a horizontal band of the screen
+    const auto rasterize = [&](const rect& band)
+    {
+        const trace::zone band_zone{"vga::blit band"};
+        for(const auto i : m_batch_order)
+        {
+            const auto& e = entries[i];
+            blit_pixels(e.pixels, e.pitch, e.source, e.x, e.y, e.key, band, raster_op::copy);
+        }
+    };
+
+    const auto num_bands = std::min(bands, m_height);
+
+    if(num_bands == 1 || m_batch_order.empty())
+    {
+        rasterize(screen);
+        return;
+    }
+
+    // bands cover disjoint rows of VRAM, so they can be rasterized in parallel;
+    // the workers are kept for later batches
+    if(m_workers == nullptr || m_workers->size() < num_bands - 1)
+    {
+        m_workers.reset();
+        m_workers = std::make_unique<detail::worker_pool>(num_bands - 1);
+    }
+
+    const auto band_height = (m_height + num_bands - 1) / num_bands;
+
+    m_workers->run(num_bands, [&](const int band)
+    {
+        const auto y0 = band * band_height;
+        const auto y1 = std::min(m_height, y0 + band_height);
+
+        if(y0 < y1)
+        {
+            rasterize({0, y0, m_width, y1 - y0});
+        }
+    });
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void vga::blit_ex(const sprite& source, const transform& t, const raster_op op)
+{
+    const trace::zone zone{"vga::blit_ex"};
+    const auto [x, y] = source.position();
+    const auto [width, height] = source.size();
+    const auto pixels = std::span{source.pixels()};
+
+    if(std::ssize(pixels) < width * height || t.scale_x <= 0 || t.scale_y <= 0)
+    {
+        throw std::invalid_argument("vga::blit_ex has an invalid argument");
+    }
+
+    // plain copy
+    if(!t.flip_x && !t.flip_y && t.scale_x == fixed_one && t.scale_y == fixed_one && t.angle == 0.0)
+    {
+        blit(source, op);
+        return;
+    }
+
+    constexpr auto one = static_cast<double>(fixed_one);
+    const auto sx = static_cast<double>(t.scale_x) / one;
+    const auto sy = static_cast<double>(t.scale_y) / one;
+    const auto cos_a = std::cos(t.angle);
+    const auto sin_a = std::sin(t.angle);
+
+    // scaled sprite is rotated about its center
+    const auto half_w = static_cast<double>(width) * sx / 2.0;
+    const auto half_h = static_cast<double>(height) * sy / 2.0;
+    const auto cx = static_cast<double>(x) + half_w;
+    const auto cy = static_cast<double>(y) + half_h;
+    count(&frame_stats::blits);
+
+    // destination bounding box
+    const auto ex = std::abs(half_w * cos_a) + std::abs(half_h * sin_a);
+    const auto ey = std::abs(half_w * sin_a) + std::abs(half_h * cos_a);
+    const auto x0 = std::max(0, static_cast<int>(std::floor(cx - ex)));
+    const auto x1 = std::min(m_width, static_cast<int>(std::ceil(cx + ex)));
+    const auto y0 = std::max(0, static_cast<int>(std::floor(cy - ey)));
+    const auto y1 = std::min(m_height, static_cast<int>(std::ceil(cy + ey)));
+
+    if(x0 >= x1 || y0 >= y1)
     {
-        const auto p = pixels | std::views::drop(width * line + w0) | std::views::take(w1);
-        const auto v = m_vram | std::views::drop(xy_to_index(x1, y1 + (line - l0)));
-        std::ranges::copy(p, v.begin());
+        return;
     }
+
+    m_vram_dirty = true;
+
+    // inverse mapping from screen to source, stepped in 16.16 fixed point
+    const auto to_fixed = [=](const double v) { return static_cast<std::int64_t>(std::lround(v * one)); };
+    const auto du_dx = to_fixed(cos_a / sx);
+    const auto dv_dx = to_fixed(-sin_a / sy);
+    const auto du_dy = to_fixed(sin_a / sx);
+    const auto dv_dy = to_fixed(cos_a / sy);
+
+    const auto rx = static_cast<double>(x0) + 0.5 - cx;
+    const auto ry = static_cast<double>(y0) + 0.5 - cy;
+    auto u_row = to_fixed((cos_a * rx + sin_a * ry) / sx + static_cast<double>(width) / 2.0);
+    auto v_row = to_fixed((-sin_a * rx + cos_a * ry) / sy + static_cast<double>(height) / 2.0);
+
+    const auto u_limit = std::int64_t{width} * fixed_one;
+    const auto v_limit = std::int64_t{height} * fixed_one;
+    const auto key = source.color_key();
+    const auto mask = m_num_colors - 1;
+
+    detail::dispatch(op, [&]<raster_op Op>(std::integral_constant<raster_op, Op>)
+    {
+        for(const auto line : std::views::iota(y0, y1))
+        {
+            // clip the row to the source
+            auto [first, last] = step_range(u_row, du_dx, u_limit, 0, x1 - x0);
+            std::tie(first, last) = step_range(v_row, dv_dx, v_limit, first, last);
+
+            auto u = u_row + du_dx * first;
+            auto v = v_row + dv_dx * first;
+            auto dst = m_vram.begin() + static_cast<std::ptrdiff_t>(xy_to_index(x0, line));
+
+            for(const auto i : std::views::iota(first, last))
+            {
+                auto src_x = static_cast<int>(u >> 16);
+                auto src_y = static_cast<int>(v >> 16);
+                src_x = t.flip_x ? (width - 1 - src_x) : src_x;
+                src_y = t.flip_y ? (height - 1 - src_y) : src_y;
+
+                const auto p = pixels[static_cast<std::size_t>(src_y * width + src_x)];
+                auto& d = dst[static_cast<std::ptrdiff_t>(i)];
+
+                if(!key.has_value() || p != key.value())
+                {
+                    d = detail::rop<Op>::apply(d, p, mask);
+                }
+
+                u += du_dx;
+                v += dv_dx;
+            }
+
+            u_row += du_dy;
+            v_row += dv_dy;
+        }
+    });
 }
 
 
 ////////////////////////////////////////////////////////////////////////////////
-void vga::clear(const int index)
+void vga::clear(const int index, const raster_op op)
 {
     if(index < 0 || index >= std::ssize(m_palette))
     {
         throw std::invalid_argument("vga::clear has an invalid argument");
     }
 
-    std::ranges::fill(m_vram, index);
+    detail::dispatch(op, [&]<raster_op Op>(std::integral_constant<raster_op, Op>)
+    {
+        detail::rop_fill<Op>(m_vram.begin(), std::ssize(m_vram), index, m_num_colors - 1);
+    });
+
+    std::ranges::fill(m_text, text_cell{});
+    m_vram_dirty = true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void vga::clear_raster()
+{
+    if(!m_raster.empty())
+    {
+        m_raster.clear();
+        m_palette_dirty = true;
+    }
 }
 
 
@@ -225,15 +690,45 @@ int vga::get_pixel(const int x, const int y) const
 }
 
 
+////////////////////////////////////////////////////////////////////////////////
+const scrollback& vga::get_scrollback() const noexcept
+{
+    return m_scrollback;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+std::pair<int, int> vga::get_text_size() const noexcept
+{
+    return {m_columns, m_rows};
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+int vga::get_view() const noexcept
+{
+    return m_view;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void vga::move_pointer(const int x, const int y) noexcept
+{
+    m_pointer_x = x;
+    m_pointer_y = y;
+}
+
+
 ////////////////////////////////////////////////////////////////////////////////
 void vga::print(const std::string_view s, const int col, const int row, const int fg, const bool update_cursor)
 {
+    const trace::zone zone{"vga::print"};
     if(col < 0 || col >= m_columns || row < 0 || row >= m_rows)
     {
         return;
     }
 
-    if(fg >= std::ssize(m_palette))
+    if(fg < 0 || fg >= std::ssize(m_palette))
     {
         throw std::invalid_argument("vga::print has an invalid argument");
     }
@@ -246,39 +741,55 @@ void vga::print(const std::string_view s, const int col, const int row, const in
 
     for(const auto c : s)
     {
-        switch(c)
-        {
-            case '\a':
-                // TODO: bell
-                break;
+        const auto byte = static_cast<unsigned char>(c);
+        print_char(byte, byte, fg);
+    }
+
+    if(!update_cursor)
+    {
+        m_cursor_col = saved_cursor_col;
+        m_cursor_row = saved_cursor_row;
+    }
+}
 
-            case '\b':
-                m_cursor_col = std::max(0, m_cursor_col - 1);
-                break;
 
-            case '\n':
-                ++m_cursor_row;
-                break;
+////////////////////////////////////////////////////////////////////////////////
+void vga::print(const std::u8string_view s, const int col, const int row, const int fg, const bool update_cursor)
+{
+    const trace::zone zone{"vga::print"};
+    if(col < 0 || col >= m_columns || row < 0 || row >= m_rows)
+    {
+        return;
+    }
 
-            case '\r':
-                m_cursor_col = 0;
-                break;
+    if(fg < 0 || fg >= std::ssize(m_palette))
+    {
+        throw std::invalid_argument("vga::print has an invalid argument");
+    }
 
-            default:
-                putchar(static_cast<unsigned char>(c), fg);
-                ++m_cursor_col;
-        }
+    [[maybe_unused]] const auto saved_cursor_col{m_cursor_col};
+    [[maybe_unused]] const auto saved_cursor_row{m_cursor_row};
+
+    m_cursor_col = col;
+    m_cursor_row = row;
 
-        if(m_cursor_col == m_columns)
+    for(auto rest = s; !rest.empty();)
+    {
+        // runs of ASCII bypass the decoder
+        const auto ascii = detail::ascii_prefix(rest);
+
+        for(const char32_t c : rest.substr(0, ascii))
         {
-            m_cursor_col = 0;
-            ++m_cursor_row;
+            print_char(c, m_font.index(c), fg);
         }
 
-        if(m_cursor_row == m_rows)
+        rest.remove_prefix(ascii);
+
+        if(!rest.empty())
         {
-            --m_cursor_row;
-            scroll_up();
+            const auto [c, length] = detail::decode(rest);
+            print_char(c, m_font.index(c), fg);
+            rest.remove_prefix(length);
         }
     }
 
@@ -291,22 +802,66 @@ void vga::print(const std::string_view s, const int col, const int row, const in
 
 
 ////////////////////////////////////////////////////////////////////////////////
-void vga::putchar(const unsigned char c, const int fg)
+void vga::put_glyph(const int col, const int row, const int index, const int fg, const int bg)
 {
-    if(fg < 0 || fg >= std::ssize(m_palette))
+    if(index < 0 || fg < 0 || fg >= std::ssize(m_palette) || bg < 0 || bg >= std::ssize(m_palette))
     {
-        throw std::invalid_argument("vga::putchar has an invalid argument");
+        throw std::invalid_argument("vga::put_glyph has an invalid argument");
     }
 
-    const auto [width, height] = m_font.size();
-    const auto glyph = m_font.glyph(c, fg, 0);
-    sprite s{width, height, glyph};
-
-    const auto x = width * m_cursor_col;
-    const auto y = height * m_cursor_row;
-    s.position(x, y);
+    if(col < 0 || col >= m_columns || row < 0 || row >= m_rows)
+    {
+        return;
+    }
 
-    blit(s);
+    set_text(col, row, index, fg, bg);
+    draw_glyph(col, row, index, fg, bg);
+    count(&frame_stats::glyphs);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void vga::putchar(const unsigned char c, const int fg)
+{
+    if(fg < 0 || fg >= std::ssize(m_palette))
+    {
+        throw std::invalid_argument("vga::putchar has an invalid argument");
+    }
+
+    if(m_cursor_col < 0 || m_cursor_col >= m_columns || m_cursor_row < 0 || m_cursor_row >= m_rows)
+    {
+        return;
+    }
+
+    set_text(m_cursor_col, m_cursor_row, c, fg, 0);
+    draw_glyph(m_cursor_col, m_cursor_row, c, fg, 0);
+    count(&frame_stats::glyphs);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void vga::raster_color(const int line, const int index, const color& c)
+{
+    if(index < 0 || index > 255)
+    {
+        throw std::invalid_argument("vga::raster_color has an invalid argument");
+    }
+
+    add_raster({line, raster_command::type::color, index, 0, c.to_argb()});
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void vga::raster_pan(const int line, const int pixels)
+{
+    add_raster({line, raster_command::type::pan, 0, pixels, 0u});
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void vga::raster_start(const int line, const int offset)
+{
+    add_raster({line, raster_command::type::start, 0, offset, 0u});
 }
 
 
@@ -315,26 +870,105 @@ void vga::reset_palette()
 {
     auto it = std::ranges::copy(ega_palette, m_palette.begin());
     std::fill(it.out, m_palette.end(), color::black);
+    m_lut_dirty = true;
 }
 
 
 ////////////////////////////////////////////////////////////////////////////////
 void vga::scroll_down(const int lines)
 {
+    const trace::zone zone{"vga::scroll_down"};
     const auto [w, h] = m_font.size();
-    const auto num_pixels = (w * m_columns) * h * std::clamp(lines, 0, m_rows);
+    const auto n = std::clamp(lines, 0, m_rows);
+    const auto num_pixels = (w * m_columns) * h * n;
     std::shift_right(m_vram.begin(), m_vram.end(), num_pixels);
     std::fill_n(m_vram.begin(), num_pixels, 0);
+
+    std::shift_right(m_text.begin(), m_text.end(), n * m_columns);
+    std::fill_n(m_text.begin(), n * m_columns, text_cell{});
+    m_vram_dirty = true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void vga::scroll_down(const rect& window, const int lines, const int fill)
+{
+    const trace::zone zone{"vga::scroll_down"};
+    if(fill < 0 || fill >= std::ssize(m_palette))
+    {
+        throw std::invalid_argument("vga::scroll_down has an invalid argument");
+    }
+
+    scroll_window(window, -std::max(lines, 0), fill);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void vga::scroll_text_down(const rect& window, const int lines, const int bg)
+{
+    const trace::zone zone{"vga::scroll_text_down"};
+    if(bg < 0 || bg >= std::ssize(m_palette))
+    {
+        throw std::invalid_argument("vga::scroll_text_down has an invalid argument");
+    }
+
+    scroll_text_window(window, -std::max(lines, 0), bg);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void vga::scroll_text_up(const rect& window, const int lines, const int bg)
+{
+    const trace::zone zone{"vga::scroll_text_up"};
+    if(bg < 0 || bg >= std::ssize(m_palette))
+    {
+        throw std::invalid_argument("vga::scroll_text_up has an invalid argument");
+    }
+
+    scroll_text_window(window, std::max(lines, 0), bg);
 }
 
 
 ////////////////////////////////////////////////////////////////////////////////
 void vga::scroll_up(const int lines)
 {
+    const trace::zone zone{"vga::scroll_up"};
     const auto [w, h] = m_font.size();
-    const auto num_pixels = (w * m_columns) * h * std::clamp(lines, 0, m_rows);
+    const auto n = std::clamp(lines, 0, m_rows);
+    const auto num_pixels = (w * m_columns) * h * n;
     std::shift_left(m_vram.begin(), m_vram.end(), num_pixels);
     std::fill_n(m_vram.rbegin(), num_pixels, 0);
+
+    // the rows scrolled off go to the scrollback, and a scrolled back view
+    // stays on the lines it shows
+    const auto text = std::span{m_text};
+
+    for(const auto row : std::views::iota(0, n))
+    {
+        m_scrollback.push(text.subspan(static_cast<std::size_t>(row * m_columns), static_cast<std::size_t>(m_columns)));
+    }
+
+    if(m_view > 0)
+    {
+        m_view = std::min(m_view + n, static_cast<int>(m_scrollback.size()));
+    }
+
+    std::shift_left(m_text.begin(), m_text.end(), n * m_columns);
+    std::fill_n(m_text.rbegin(), n * m_columns, text_cell{});
+    m_vram_dirty = true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void vga::scroll_up(const rect& window, const int lines, const int fill)
+{
+    const trace::zone zone{"vga::scroll_up"};
+    if(fill < 0 || fill >= std::ssize(m_palette))
+    {
+        throw std::invalid_argument("vga::scroll_up has an invalid argument");
+    }
+
+    scroll_window(window, std::max(lines, 0), fill);
 }
 
 
@@ -347,14 +981,39 @@ void vga::set_color(const int index, const color& c)
     }
 
     m_palette[static_cast<std::size_t>(index)] = c;
+
+    // a single entry is updated in place unless a fade owns the table
+    if(m_fade.has_value())
+    {
+        m_lut_dirty = true;
+        return;
+    }
+
+    m_lut[static_cast<std::size_t>(index)] = c.to_argb();
+    m_palette_dirty = true;
 }
 
 
 ////////////////////////////////////////////////////////////////////////////////
 void vga::set_cursor(const int col, const int row)
 {
-    m_cursor_col = col % m_columns;
-    m_cursor_row = row % m_rows;
+    // positions wrap around the screen, negative ones from the end
+    m_cursor_col = ((col % m_columns) + m_columns) % m_columns;
+    m_cursor_row = ((row % m_rows) + m_rows) % m_rows;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void vga::set_cursor_shape(const cursor_shape shape, const std::chrono::milliseconds blink)
+{
+    if(blink < std::chrono::milliseconds::zero())
+    {
+        throw std::invalid_argument("vga::set_cursor_shape has an invalid argument");
+    }
+
+    m_cursor_shape = shape;
+    m_cursor_blink = blink;
+    m_blink_start = clock::now();
 }
 
 
@@ -368,12 +1027,11 @@ void vga::set_font(const font& f)
 ////////////////////////////////////////////////////////////////////////////////
 void vga::set_mode(const vga::mode video_mode)
 {
+    const trace::zone zone{"vga::set_mode"};
     const auto mode = vga_modes.at(video_mode);
     m_width = mode.width;
     m_height = mode.height;
     m_num_colors = mode.num_colors;
-    m_vram.resize(static_cast<std::size_t>(m_width * m_height));
-    m_palette.resize(static_cast<std::size_t>(m_num_colors));
 
     m_font = mode.font;
     const auto [font_w, font_h] = m_font.size();
@@ -382,27 +1040,69 @@ void vga::set_mode(const vga::mode video_mode)
     m_cursor_col = 0;
     m_cursor_row = 0;
 
-    m_pixels.resize(static_cast<std::size_t>(m_width * m_height));
+    m_cycles.clear();
+    m_fade.reset();
+    m_raster.clear();
+    m_split_line = m_height;
+    m_split_origin = 0;
+    m_lut_dirty = true;
+    m_vram_dirty = true;
 
-    SDL_SetHint(SDL_HINT_RENDER_SCALE_QUALITY, "linear");
-    SDL_RenderSetLogicalSize(m_renderer, m_width, m_height);
+    // scrollback lines are as wide as the text screen they came from
+    m_scrollback.clear();
+    m_view = 0;
+    m_overlays = {};
 
-    SDL_SetRenderDrawColor(m_renderer, 0, 0, 0, 255);
-    SDL_RenderClear(m_renderer);
-    SDL_RenderPresent(m_renderer);
+    if(m_renderer != nullptr)
+    {
+        SDL_RenderSetLogicalSize(m_renderer, m_width, m_height);
+    }
 
-    if(m_texture != nullptr)
+    if(m_mode == video_mode)
     {
-        SDL_DestroyTexture(m_texture);
-        m_texture = nullptr;
+        return;
     }
 
-    m_texture = SDL_CreateTexture(m_renderer, SDL_PIXELFORMAT_ARGB8888,
-                                  SDL_TEXTUREACCESS_STREAMING, m_width, m_height);
+    // a mode entered for the first time starts with the current palette
+    auto& cached = m_mode_cache[video_mode];
 
-    if(m_texture == nullptr)
+    if(cached.vram.empty())
     {
-        throw std::runtime_error(SDL_GetError());
+        cached.palette = m_palette;
+    }
+
+    // park the buffers of the current mode and take over those of the new one;
+    // the cache entries are created once, so later switches only swap pointers
+    if(m_mode.has_value())
+    {
+        auto& parked = m_mode_cache[*m_mode];
+        std::swap(parked.texture, m_texture);
+        std::swap(parked.vram, m_vram);
+        std::swap(parked.pixels, m_pixels);
+        std::swap(parked.text, m_text);
+        std::swap(parked.palette, m_palette);
+    }
+
+    std::swap(cached.texture, m_texture);
+    std::swap(cached.vram, m_vram);
+    std::swap(cached.pixels, m_pixels);
+    std::swap(cached.text, m_text);
+    std::swap(cached.palette, m_palette);
+
+    m_mode = video_mode;
+    m_palette.resize(static_cast<std::size_t>(m_num_colors));
+
+    if(m_vram.empty())
+    {
+        const auto size = static_cast<std::size_t>(m_width * m_height);
+        m_vram.assign(size, 0);
+        m_pixels.assign(size, 0u);
+        m_text.assign(static_cast<std::size_t>(m_columns * m_rows), text_cell{});
+    }
+
+    if(m_texture == nullptr && m_renderer != nullptr)
+    {
+        create_texture();
     }
 }
 
@@ -416,6 +1116,7 @@ void vga::set_palette(const std::span<const color> colors)
     }
 
     std::ranges::copy(colors, m_palette.begin());
+    m_lut_dirty = true;
 }
 
 
@@ -433,30 +1134,804 @@ void vga::set_pixel(const int x, const int y, const int color_index)
     }
 
     m_vram[xy_to_index(x % m_width, y % m_height)] = color_index;
+    m_vram_dirty = true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void vga::set_pointer(const sprite& image, const int hot_x, const int hot_y)
+{
+    const auto [width, height] = image.size();
+    m_pointer = {image.pixels(), width, height, hot_x, hot_y, image.color_key()};
+    m_pointer_changed = true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void vga::set_scrollback(const std::size_t depth)
+{
+    m_scrollback = scrollback{depth};
+    m_view = 0;
+    m_vram_dirty = true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void vga::set_split(const int line, const int origin)
+{
+    if(line < 0 || line > m_height)
+    {
+        throw std::invalid_argument("vga::set_split has an invalid argument");
+    }
+
+    m_split_line = line;
+    m_split_origin = origin;
+
+    // the split changes the whole displayed frame
+    m_palette_dirty = true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void vga::set_view(const int lines)
+{
+    m_view = std::clamp(lines, 0, static_cast<int>(m_scrollback.size()));
+    m_vram_dirty = true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void vga::set_vsync(const vsync mode)
+{
+    m_vsync = mode;
+
+    // a deferred display takes the setting when it is created
+    if(m_renderer != nullptr)
+    {
+        set_renderer_vsync(m_renderer, mode);
+    }
 }
 
 
 ////////////////////////////////////////////////////////////////////////////////
 void vga::show()
 {
-    std::ranges::transform(m_vram, m_pixels.begin(), [&](auto i)
+    const trace::zone zone{"vga::show"};
+    const auto timed = timing();
+    const auto start = timed ? clock::now() : clock::time_point{};
+
+    if(m_renderer == nullptr)
     {
-        return m_palette[static_cast<std::size_t>(i)].to_argb();
-    });
+        create_display();
+    }
+
+    update_palette();
+
+    // changed rectangles only map to the same place on screen when every line
+    // is displayed from its own place in VRAM
+    if(!m_dirty_rects.empty() && (!m_raster.empty() || m_split_line < m_height || m_view > 0))
+    {
+        m_vram_dirty = true;
+    }
 
     const auto pitch = m_width * static_cast<int>(sizeof(std::uint32_t));
-    SDL_UpdateTexture(m_texture, nullptr, m_pixels.data(), pitch);
+    const auto full_frame = m_vram_dirty || m_palette_dirty;
+    const auto uploaded = full_frame || !m_dirty_rects.empty();
+
+    // the texture keeps the last frame if neither VRAM nor the palette changed
+    if(full_frame)
+    {
+        {
+            const trace::zone convert_zone{"convert"};
+            const detail::scoped_timer timer{m_counters.convert, timed};
+
+            // a scrolled back view is displayed in place of VRAM
+            if(m_view > 0)
+            {
+                render_view();
+                std::swap(m_vram, m_view_vram);
+                convert();
+                std::swap(m_vram, m_view_vram);
+            }
+            else
+            {
+                convert();
+            }
+        }
+
+        count(&frame_stats::pixels_converted, m_pixels.size());
+
+        const trace::zone upload_zone{"upload"};
+        const detail::scoped_timer timer{m_counters.upload, timed};
+        SDL_UpdateTexture(m_texture, nullptr, m_pixels.data(), pitch);
+        m_counters.bytes_uploaded += m_pixels.size() * sizeof(std::uint32_t);
+
+        m_vram_dirty = false;
+        m_palette_dirty = false;
+    }
+    else
+    {
+        {
+            const trace::zone convert_zone{"convert"};
+            const detail::scoped_timer timer{m_counters.convert, timed};
+
+            // only the changed rectangles are converted and uploaded
+            for(const auto& r : m_dirty_rects)
+            {
+                count(&frame_stats::pixels_converted, static_cast<std::size_t>(r.width * r.height));
+
+                for(const auto y : std::views::iota(r.y, r.y + r.height))
+                {
+                    const auto first = static_cast<std::ptrdiff_t>(xy_to_index(r.x, y));
+                    std::transform(m_vram.begin() + first, m_vram.begin() + first + r.width, m_pixels.begin() + first,
+                                   [&](const int i) { return m_lut[static_cast<std::size_t>(i) & 0xffu]; });
+                }
+            }
+        }
+
+        const trace::zone upload_zone{"upload"};
+        const detail::scoped_timer timer{m_counters.upload, timed};
+
+        for(const auto& r : m_dirty_rects)
+        {
+            const auto area = static_cast<std::size_t>(r.width * r.height);
+            const SDL_Rect bounds{r.x, r.y, r.width, r.height};
+            SDL_UpdateTexture(m_texture, &bounds, m_pixels.data() + xy_to_index(r.x, r.y), pitch);
+            m_counters.bytes_uploaded += area * sizeof(std::uint32_t);
+        }
+
+        count(&frame_stats::dirty_rects, m_dirty_rects.size());
+    }
+
+    m_dirty_rects.clear();
+
+    {
+        const trace::zone overlay_zone{"overlays"};
+        draw_overlays(full_frame, uploaded);
+    }
 
     SDL_RenderClear(m_renderer);
-    SDL_RenderCopy(m_renderer, m_texture, nullptr, nullptr);
-    SDL_RenderPresent(m_renderer);
+
+    {
+        const trace::zone copy_zone{"render copy"};
+        const detail::scoped_timer timer{m_counters.render_copy, timed};
+        SDL_RenderCopy(m_renderer, m_texture, nullptr, nullptr);
+    }
+
+    {
+        const trace::zone present_zone{"present"};
+        const detail::scoped_timer timer{m_counters.present, timed};
+        SDL_RenderPresent(m_renderer);
+    }
+
+    if(m_hud_visible)
+    {
+        if(m_last_frame != clock::time_point{})
+        {
+            m_samples[m_next_sample] = {start - m_last_frame, m_counters.convert, m_counters.bytes_uploaded};
+            m_next_sample = (m_next_sample + 1) % m_samples.size();
+            m_num_samples = std::min(m_num_samples + 1, m_samples.size());
+        }
+
+        m_last_frame = start;
+    }
+
+    if constexpr(detail::stats_enabled)
+    {
+        const auto allocations = detail::allocation_count();
+        m_counters.allocations = allocations - std::exchange(m_allocations, allocations);
+        m_stats = m_counters;
+    }
+
+    m_counters = {};
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void vga::show_hud(const bool visible)
+{
+    m_hud_visible = visible;
+
+    // timing starts over, so the first sample is not the time spent hidden
+    m_num_samples = 0;
+    m_next_sample = 0;
+    m_last_frame = {};
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void vga::show_pointer(const bool visible) noexcept
+{
+    m_pointer_visible = visible;
+    m_pointer_changed = true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+std::chrono::microseconds vga::startup_time() const noexcept
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(m_startup);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+vga::frame_stats vga::stats() const noexcept
+{
+    return m_stats;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void vga::add_raster(const raster_command& command)
+{
+    const auto it = std::ranges::upper_bound(m_raster, command.line, {}, &raster_command::line);
+    m_raster.insert(it, command);
+
+    // raster commands change the whole displayed frame
+    m_palette_dirty = true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+bool vga::blit_pixels(const std::span<const int> pixels, const int pitch, const rect& source,
+                      const int x, const int y, const std::optional<int> key, const rect& bounds,
+                      const raster_op op)
+{
+    const auto r = clip(x, y, source.width, source.height, bounds);
+
+    // source completely out of bounds
+    if(!r.has_value())
+    {
+        return false;
+    }
+
+    const auto mask = m_num_colors - 1;
+
+    detail::dispatch(op, [&]<raster_op Op>(std::integral_constant<raster_op, Op>)
+    {
+        for(const auto line : std::views::iota(0, r->height))
+        {
+            const auto offset = pitch * (source.y + r->src_y + line) + source.x + r->src_x;
+            const auto p = pixels.subspan(static_cast<std::size_t>(offset), static_cast<std::size_t>(r->width));
+            const auto v = m_vram.begin() + static_cast<std::ptrdiff_t>(xy_to_index(r->dst_x, r->dst_y + line));
+
+            if(key.has_value())
+            {
+                // skip transparent pixels
+                detail::rop_copy_keyed<Op>(p, v, key.value(), mask);
+                continue;
+            }
+
+            detail::rop_copy<Op>(p, v, mask);
+        }
+    });
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void vga::convert()
+{
+    const auto to_argb = [](const auto& lut)
+    {
+        return [&](const int i) { return lut[static_cast<std::size_t>(i) & 0xffu]; };
+    };
+
+    if(m_raster.empty() && m_split_line >= m_height)
+    {
+        std::ranges::transform(m_vram, m_pixels.begin(), to_argb(m_lut));
+        return;
+    }
+
+    // replay the raster commands on a copy of the display registers
+    auto lut = m_lut;
+    auto pan = 0;
+    auto start = 0;
+    auto command = m_raster.begin();
+
+    const auto vram = std::span{m_vram};
+    const auto size = std::ssize(m_vram);
+
+    for(const auto line : std::views::iota(0, m_height))
+    {
+        for(; command != m_raster.end() && command->line <= line; ++command)
+        {
+            switch(command->what)
+            {
+                case raster_command::type::color:
+                    lut[static_cast<std::size_t>(command->index)] = command->argb;
+                    break;
+
+                case raster_command::type::pan:
+                    pan = command->value;
+                    break;
+
+                case raster_command::type::start:
+                    start = command->value;
+                    break;
+            }
+        }
+
+        // the split screen restarts at its own origin, without pan
+        const auto split = (line >= m_split_line);
+        const auto base = split ? m_split_origin : start;
+        const auto row = split ? (line - m_split_line) : line;
+
+        // source line, wrapped around the end of VRAM
+        auto offset = (base + static_cast<std::ptrdiff_t>(row) * m_width) % size;
+        offset += (offset < 0) ? size : 0;
+
+        const auto first = static_cast<std::size_t>(offset);
+        const auto count = static_cast<std::size_t>(std::min<std::ptrdiff_t>(m_width, size - offset));
+        const auto src = vram.subspan(first, count);
+        const auto dst = m_pixels.begin() + static_cast<std::ptrdiff_t>(xy_to_index(0, line));
+
+        std::ranges::transform(src, dst, to_argb(lut));
+        std::ranges::transform(vram.first(static_cast<std::size_t>(m_width) - count),
+                               dst + static_cast<std::ptrdiff_t>(count), to_argb(lut));
+
+        // pan rotates the line within itself
+        if(const auto shift = ((pan % m_width) + m_width) % m_width; !split && shift != 0)
+        {
+            std::rotate(dst, dst + shift, dst + m_width);
+        }
+    }
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+void vga::create_display()
+{
+    const auto start = clock::now();
+
+    SDL_CreateWindowAndRenderer(0, 0, SDL_WINDOW_FULLSCREEN_DESKTOP, &m_window, &m_renderer);
+
+    if(m_window == nullptr || m_renderer == nullptr)
+    {
+        throw std::runtime_error(SDL_GetError());
+    }
+
+    SDL_SetHint(SDL_HINT_RENDER_SCALE_QUALITY, "linear");
+    SDL_SetRenderDrawColor(m_renderer, 0, 0, 0, 255);
+    SDL_RenderSetLogicalSize(m_renderer, m_width, m_height);
+
+    if(m_vsync.has_value())
+    {
+        set_renderer_vsync(m_renderer, *m_vsync);
+    }
+
+    create_texture();
+
+    m_startup += clock::now() - start;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void vga::create_texture()
+{
+    m_texture = SDL_CreateTexture(m_renderer, SDL_PIXELFORMAT_ARGB8888,
+                                  SDL_TEXTUREACCESS_STREAMING, m_width, m_height);
+
+    if(m_texture == nullptr)
+    {
+        throw std::runtime_error(SDL_GetError());
+    }
+
+    // the new texture holds no frame yet
+    m_vram_dirty = true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void vga::count(std::size_t frame_stats::* const counter, const std::size_t n) noexcept
+{
+    if constexpr(detail::stats_enabled)
+    {
+        m_counters.*counter += n;
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void vga::draw_glyph(const int col, const int row, const int index, const int fg, const int bg)
+{
+    const auto [width, height] = m_font.size();
+    const auto x = width * col;
+    const auto y = height * row;
+    const auto rows = m_font.rows(index);
+
+    // glyphs with 8 bit rows fully on screen render from the pre-expanded row masks
+    if(m_font.stride() == 1 && std::ssize(rows) == height && x >= 0 && y >= 0 &&
+       x + width <= m_width && y + height <= m_height)
+    {
+        const auto glyph_width = width - m_font.spacing();
+        auto dst = m_vram.begin() + static_cast<std::ptrdiff_t>(xy_to_index(x, y));
+
+        for(const auto bits : rows)
+        {
+            const auto& mask = detail::row_masks[std::to_integer<std::size_t>(bits)];
+            const auto last = std::ranges::transform(mask | std::views::take(glyph_width), dst,
+                                                     [=](const int m) { return bg ^ ((fg ^ bg) & m); }).out;
+            std::fill(last, dst + width, bg);
+
+            dst += m_width;
+        }
+
+        mark_dirty({x, y, width, height});
+        return;
+    }
+
+    const auto glyph = m_font.glyph(index, fg, bg);
+    sprite s{width, height, glyph};
+    s.position(x, y);
+
+    blit(s);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void vga::draw_hud()
+{
+    using milliseconds = std::chrono::duration<double, std::milli>;
+
+    frame_sample total{};
+    clock::duration worst{};
+
+    for(const auto& sample : std::span{m_samples}.first(m_num_samples))
+    {
+        total.frame += sample.frame;
+        total.convert += sample.convert;
+        total.upload_bytes += sample.upload_bytes;
+        worst = std::max(worst, sample.frame);
+    }
+
+    const auto n = static_cast<double>(std::max(m_num_samples, std::size_t{1}));
+    const auto frame_ms = milliseconds{total.frame}.count() / n;
+    const auto fps = (frame_ms > 0.0) ? 1000.0 / frame_ms : 0.0;
+
+    std::array<std::array<char, hud_columns + 1>, hud_lines> text{};
+    std::snprintf(text[0].data(), text[0].size(), "%6.1f fps", fps);
+    std::snprintf(text[1].data(), text[1].size(), "frame %6.2f max %6.2f", frame_ms, milliseconds{worst}.count());
+    std::snprintf(text[2].data(), text[2].size(), "convert %6.2f ms", milliseconds{total.convert}.count() / n);
+    std::snprintf(text[3].data(), text[3].size(), "upload %8.1f KB", static_cast<double>(total.upload_bytes) / n / 1024.0);
+
+    const auto& hud = *m_overlays[1];
+    m_hud_pixels.assign(static_cast<std::size_t>(hud.width * hud.height), hud_background);
+
+    for(const auto line : std::views::iota(0, hud_lines))
+    {
+        const std::string_view s{text[static_cast<std::size_t>(line)].data()};
+
+        for(const auto col : std::views::iota(0, static_cast<int>(s.size())))
+        {
+            const auto rows = vga_8x8.rows(static_cast<unsigned char>(s[static_cast<std::size_t>(col)]));
+
+            for(const auto r : std::views::iota(0, static_cast<int>(rows.size())))
+            {
+                const auto y = hud_margin + line * 8 + r;
+                const auto bits = std::to_integer<unsigned>(rows[static_cast<std::size_t>(r)]);
+
+                for(const auto bit : std::views::iota(0, 8))
+                {
+                    const auto x = hud_margin + col * 8 + bit;
+
+                    if(x < hud.width && y < hud.height && ((bits << bit) & 0x80u) != 0u)
+                    {
+                        m_hud_pixels[static_cast<std::size_t>(y * hud.width + x)] = hud_foreground;
+                    }
+                }
+            }
+        }
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void vga::draw_overlays(const bool full_frame, const bool uploaded)
+{
+    std::array<std::optional<rect>, 3> current{};
+
+    // the cursor shows for the first half of each blink period, and not while
+    // the view is scrolled back
+    const auto elapsed = clock::now() - m_blink_start;
+    const auto blink_on = (m_cursor_blink == clock::duration::zero()) || ((elapsed * 2 / m_cursor_blink) % 2 == 0);
+
+    if(m_cursor_shape != cursor_shape::none && blink_on && m_view == 0)
+    {
+        const auto [w, h] = m_font.size();
+        const auto top = (m_cursor_shape == cursor_shape::underline) ? h - 2 : 0;
+        current[0] = rect{m_cursor_col * w, m_cursor_row * h + top, w, h - top};
+    }
+
+    if(m_pointer_visible && !m_pointer.pixels.empty())
+    {
+        const auto x = m_pointer_x - m_pointer.hot_x;
+        const auto y = m_pointer_y - m_pointer.hot_y;
+
+        if(const auto c = clip(x, y, m_pointer.width, m_pointer.height, {0, 0, m_width, m_height}); c.has_value())
+        {
+            current[2] = rect{c->dst_x, c->dst_y, c->width, c->height};
+        }
+    }
+
+    if(m_hud_visible)
+    {
+        current[1] = rect{0, 0, std::min(hud_width, m_width), std::min(hud_height, m_height)};
+    }
+
+    if(!uploaded && current == m_overlays && !m_hud_visible && !m_pointer_changed)
+    {
+        return;
+    }
+
+    const auto previous = std::exchange(m_overlays, current);
+    const auto pointer_changed = std::exchange(m_pointer_changed, false);
+
+    if(m_hud_visible)
+    {
+        draw_hud();
+    }
+
+    // the frame shows again where an overlay was and no longer is
+    if(!full_frame)
+    {
+        for(const auto& r : previous)
+        {
+            if(r.has_value() && std::ranges::find(current, r) == current.end())
+            {
+                present_overlays(*r);
+            }
+        }
+    }
+
+    // an overlay that did not move is redrawn only if the frame under it may
+    // have been uploaded, except the HUD, which changes every frame, and a
+    // pointer given a new image or hot spot
+    for(const auto i : std::views::iota(std::size_t{0}, current.size()))
+    {
+        const auto& r = current[i];
+
+        if(r.has_value() && (uploaded || i == 1 || (i == 2 && pointer_changed) ||
+                             std::ranges::find(previous, r) == previous.end()))
+        {
+            present_overlays(*r);
+        }
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void vga::mark_dirty(const rect& area)
+{
+    // a full frame is pending anyway
+    if(m_vram_dirty)
+    {
+        return;
+    }
+
+    // neighbouring cells of a line of text join into one rectangle
+    if(!m_dirty_rects.empty())
+    {
+        auto& last = m_dirty_rects.back();
+
+        if(last.y == area.y && last.height == area.height && last.x + last.width == area.x)
+        {
+            last.width += area.width;
+            return;
+        }
+    }
+
+    if(m_dirty_rects.size() == max_dirty_rects)
+    {
+        m_dirty_rects.clear();
+        m_vram_dirty = true;
+        return;
+    }
+
+    m_dirty_rects.push_back(area);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void vga::present_overlays(const rect& area)
+{
+    m_overlay_pixels.resize(static_cast<std::size_t>(area.width * area.height));
+
+    const auto row = [&](const int y)
+    {
+        return m_overlay_pixels.begin() + static_cast<std::ptrdiff_t>((y - area.y) * area.width);
+    };
+
+    for(const auto y : std::views::iota(area.y, area.y + area.height))
+    {
+        std::copy_n(m_pixels.begin() + static_cast<std::ptrdiff_t>(xy_to_index(area.x, y)), area.width, row(y));
+    }
+
+    // the cursor takes the foreground color of the character under it
+    if(const auto& cursor = m_overlays[0]; cursor.has_value())
+    {
+        if(const auto c = clip(cursor->x, cursor->y, cursor->width, cursor->height, area); c.has_value())
+        {
+            const auto& cell = m_text[static_cast<std::size_t>(m_cursor_row * m_columns + m_cursor_col)];
+            const auto argb = m_lut[(cell == text_cell{}) ? 7u : cell.fg];
+
+            for(const auto y : std::views::iota(c->dst_y, c->dst_y + c->height))
+            {
+                std::fill_n(row(y) + (c->dst_x - area.x), c->width, argb);
+            }
+        }
+    }
+
+    if(const auto& hud = m_overlays[1]; hud.has_value())
+    {
+        if(const auto c = clip(hud->x, hud->y, hud->width, hud->height, area); c.has_value())
+        {
+            for(const auto j : std::views::iota(0, c->height))
+            {
+                const auto src = m_hud_pixels.begin() + static_cast<std::ptrdiff_t>((c->src_y + j) * hud->width + c->src_x);
+                std::copy_n(src, c->width, row(c->dst_y + j) + (c->dst_x - area.x));
+            }
+        }
+    }
+
+    if(m_overlays[2].has_value())
+    {
+        const auto x = m_pointer_x - m_pointer.hot_x;
+        const auto y = m_pointer_y - m_pointer.hot_y;
+
+        if(const auto c = clip(x, y, m_pointer.width, m_pointer.height, area); c.has_value())
+        {
+            for(const auto j : std::views::iota(0, c->height))
+            {
+                const auto src = m_pointer.pixels.begin() + static_cast<std::ptrdiff_t>((c->src_y + j) * m_pointer.width + c->src_x);
+                const auto dst = row(c->dst_y + j) + (c->dst_x - area.x);
+
+                for(const auto i : std::views::iota(0, c->width))
+                {
+                    if(src[i] != m_pointer.key)
+                    {
+                        dst[i] = m_lut[static_cast<std::size_t>(src[i]) & 0xffu];
+                    }
+                }
+            }
+        }
+    }
+
+    const detail::scoped_timer timer{m_counters.upload, timing()};
+    const SDL_Rect r{area.x, area.y, area.width, area.height};
+    SDL_UpdateTexture(m_texture, &r, m_overlay_pixels.data(), area.width * static_cast<int>(sizeof(std::uint32_t)));
+    m_counters.bytes_uploaded += m_overlay_pixels.size() * sizeof(std::uint32_t);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void vga::print_char(const char32_t c, const int index, const int fg)
+{
+    switch(c)
+    {
+        case '\a':
+            // TODO: bell
+            break;
+
+        case '\b':
+            m_cursor_col = std::max(0, m_cursor_col - 1);
+            break;
+
+        case '\n':
+            ++m_cursor_row;
+            break;
+
+        case '\r':
+            m_cursor_col = 0;
+            break;
+
+        default:
+            set_text(m_cursor_col, m_cursor_row, index, fg, 0);
+            draw_glyph(m_cursor_col, m_cursor_row, index, fg, 0);
+            count(&frame_stats::glyphs);
+            ++m_cursor_col;
+    }
+
+    if(m_cursor_col == m_columns)
+    {
+        m_cursor_col = 0;
+        ++m_cursor_row;
+    }
+
+    if(m_cursor_row == m_rows)
+    {
+        --m_cursor_row;
+        scroll_up();
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void vga::render_view()
+{
+    // glyphs are drawn to VRAM, so the view buffer stands in for it meanwhile
+    std::swap(m_vram, m_view_vram);
+    m_vram.assign(m_view_vram.size(), 0);
+    m_view_line.resize(static_cast<std::size_t>(m_columns));
+
+    const auto history = static_cast<int>(m_scrollback.size());
+
+    for(const auto row : std::views::iota(0, m_rows))
+    {
+        // the view shows the last lines of the scrollback followed by the screen
+        const auto line = history - m_view + row;
+        auto cells = std::span<const text_cell>{m_view_line};
+
+        if(line < history)
+        {
+            m_scrollback.line(static_cast<std::size_t>(history - 1 - line), m_view_line);
+        }
+        else
+        {
+            cells = std::span{m_text}.subspan(static_cast<std::size_t>((line - history) * m_columns),
+                                              static_cast<std::size_t>(m_columns));
+        }
+
+        for(const auto col : std::views::iota(0, m_columns))
+        {
+            if(const auto& c = cells[static_cast<std::size_t>(col)]; c != text_cell{})
+            {
+                draw_glyph(col, row, c.glyph, c.fg, c.bg);
+            }
+        }
+    }
+
+    std::swap(m_vram, m_view_vram);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void vga::scroll_text_window(const rect& window, const int lines, const int bg)
+{
+    const auto cells = clip(window.x, window.y, window.width, window.height, {0, 0, m_columns, m_rows});
+
+    if(!cells.has_value() || lines == 0)
+    {
+        return;
+    }
+
+    shift_rows(m_text, m_columns, *cells, lines, text_cell{0, 0, static_cast<std::uint8_t>(bg)});
+
+    const auto [w, h] = m_font.size();
+    scroll_window({cells->dst_x * w, cells->dst_y * h, cells->width * w, cells->height * h}, lines * h, bg);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void vga::scroll_window(const rect& window, const int lines, const int fill)
+{
+    const auto area = clip(window.x, window.y, window.width, window.height, {0, 0, m_width, m_height});
+
+    if(!area.has_value() || lines == 0)
+    {
+        return;
+    }
+
+    shift_rows(m_vram, m_width, *area, lines, fill);
+    mark_dirty({area->dst_x, area->dst_y, area->width, area->height});
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void vga::set_text(const int col, const int row, const int index, const int fg, const int bg) noexcept
+{
+    m_text[static_cast<std::size_t>(row * m_columns + col)] = {static_cast<std::uint16_t>(index),
+                                                              static_cast<std::uint8_t>(fg),
+                                                              static_cast<std::uint8_t>(bg)};
 }
 
 
 ////////////////////////////////////////////////////////////////////////////////
-constexpr std::size_t vga::xy_to_index(const int x, const int y) const noexcept
+bool vga::timing() const noexcept
 {
-    return static_cast<std::size_t>(x + m_width * y);
+    return detail::stats_enabled || m_hud_visible;
 }
 
 }   // retro
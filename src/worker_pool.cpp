@@ -0,0 +1,128 @@
+////////////////////////////////////////////////////////////////////////////////
+// Retro - Retro Computing Library
+// Copyright (c) 2023 Ryan Clarke
+////////////////////////////////////////////////////////////////////////////////
+
+#include "worker_pool.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <ranges>
+#include <stdexcept>
+#include <stop_token>
+#include <utility>
+
+
+////////////////////////////////////////////////////////////////////////////////
+namespace retro::detail
+{
+
+////////////////////////////////////////////////////////////////////////////////
+worker_pool::worker_pool(const int threads)
+{
+    if(threads < 0)
+    {
+        throw std::invalid_argument("worker_pool ctor has an invalid argument");
+    }
+
+    // threads already started are stopped and joined if a later one fails
+    m_threads.reserve(static_cast<std::size_t>(threads));
+
+    for([[maybe_unused]] const auto i : std::views::iota(0, threads))
+    {
+        m_threads.emplace_back([this](const std::stop_token stop) { work(stop); });
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void worker_pool::run(const int count, const std::function<void(int)>& task)
+{
+    if(count <= 0)
+    {
+        return;
+    }
+
+    std::unique_lock lock{m_mutex};
+
+    m_task = &task;
+    m_count = count;
+    m_next = 0;
+    m_pending = count;
+    m_error = nullptr;
+    ++m_job;
+    m_start.notify_all();
+
+    drain(lock);
+    m_done.wait(lock, [this] { return m_pending == 0; });
+
+    m_task = nullptr;
+    m_count = 0;
+
+    if(m_error != nullptr)
+    {
+        std::rethrow_exception(std::exchange(m_error, nullptr));
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+int worker_pool::size() const noexcept
+{
+    return static_cast<int>(m_threads.size());
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void worker_pool::drain(std::unique_lock<std::mutex>& lock)
+{
+    while(m_next < m_count)
+    {
+        const auto index = m_next++;
+        const auto& task = *m_task;
+
+        lock.unlock();
+        std::exception_ptr error;
+
+        try
+        {
+            task(index);
+        }
+        catch(...)
+        {
+            error = std::current_exception();
+        }
+
+        lock.lock();
+
+        if(error != nullptr && m_error == nullptr)
+        {
+            m_error = std::move(error);
+        }
+
+        if(--m_pending == 0)
+        {
+            m_done.notify_all();
+        }
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void worker_pool::work(const std::stop_token stop)
+{
+    std::unique_lock lock{m_mutex};
+    auto job = std::uint64_t{0};
+
+    // a worker that wakes after its job was taken by others finds no tasks left
+    while(m_start.wait(lock, stop, [&] { return m_job != job; }))
+    {
+        job = m_job;
+        drain(lock);
+    }
+}
+
+}   // retro::detail
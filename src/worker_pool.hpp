@@ -0,0 +1,84 @@
+////////////////////////////////////////////////////////////////////////////////
+// Retro - Retro Computing Library
+// Copyright (c) 2023 Ryan Clarke
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef RETRO_WORKER_POOL_HPP
+#define RETRO_WORKER_POOL_HPP
+
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+#include <vector>
+
+
+////////////////////////////////////////////////////////////////////////////////
+namespace retro::detail
+{
+
+////////////////////////////////////////////////////////////////////////////////
+/// \brief Threads kept waiting between jobs, so that work split across them
+/// does not pay for creating threads on every call.
+////////////////////////////////////////////////////////////////////////////////
+class worker_pool
+{
+  public:
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Start the worker threads.
+    /// \param threads number of threads
+    ////////////////////////////////////////////////////////////////////////////
+    explicit worker_pool(int threads);
+
+    worker_pool(const worker_pool&) = delete;
+    worker_pool& operator=(const worker_pool&) = delete;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Run a job on the workers and the calling thread, and wait for it
+    /// to finish. The first exception thrown by a task is rethrown.
+    /// \param count number of tasks
+    /// \param task task, called with each index from 0 to count - 1
+    ////////////////////////////////////////////////////////////////////////////
+    void run(int count, const std::function<void(int)>& task);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Get the number of worker threads.
+    /// \return number of threads
+    ////////////////////////////////////////////////////////////////////////////
+    [[nodiscard]] int size() const noexcept;
+
+  private:
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Run tasks of the current job until none are left.
+    /// \param lock lock of the pool mutex, held on entry and exit
+    ////////////////////////////////////////////////////////////////////////////
+    void drain(std::unique_lock<std::mutex>& lock);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// \brief Body of a worker thread.
+    /// \param stop stop requested when the pool is destroyed
+    ////////////////////////////////////////////////////////////////////////////
+    void work(std::stop_token stop);
+
+    std::mutex m_mutex;
+    std::condition_variable_any m_start;        // a job was posted
+    std::condition_variable m_done;             // the last task of a job finished
+
+    const std::function<void(int)>* m_task{nullptr};
+    int m_count{};                              // tasks in the current job
+    int m_next{};                               // next task to start
+    int m_pending{};                            // tasks not finished
+    std::uint64_t m_job{};                      // jobs posted
+    std::exception_ptr m_error;
+
+    // declared last, so the threads are stopped and joined before the rest
+    std::vector<std::jthread> m_threads;
+};
+
+}   // retro::detail
+
+
+#endif  // RETRO_WORKER_POOL_HPP
@@ -0,0 +1,131 @@
+////////////////////////////////////////////////////////////////////////////////
+// Retro - Retro Computing Library
+// Copyright (c) 2023 Ryan Clarke
+////////////////////////////////////////////////////////////////////////////////
+
+#include <retro/font.hpp>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+
+////////////////////////////////////////////////////////////////////////////////
+namespace
+{
+
+////////////////////////////////////////////////////////////////////////////////
+/// \brief Build a PSF2 file.
+/// \param count number of glyphs
+/// \param glyph_size bytes per glyph
+/// \param height glyph height (pixels)
+/// \param width glyph width (pixels)
+/// \param data_size bytes of glyph data following the header
+/// \return file contents
+////////////////////////////////////////////////////////////////////////////////
+std::string psf2(const std::uint32_t count, const std::uint32_t glyph_size, const std::uint32_t height,
+                 const std::uint32_t width, const std::size_t data_size)
+{
+    std::string s{"\x72\xb5\x4a\x86"};
+
+    for(const auto value : {0u, 32u, 0u, count, glyph_size, height, width})
+    {
+        for(const auto shift : {0u, 8u, 16u, 24u})
+        {
+            s.push_back(static_cast<char>((value >> shift) & 0xffu));
+        }
+    }
+
+    return s + std::string(data_size, '\0');
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// \brief Write a file and load it.
+/// \param contents file contents
+/// \param load font loader
+/// \return true if the loader rejected the file with std::runtime_error
+////////////////////////////////////////////////////////////////////////////////
+bool rejects(const std::string_view contents, const std::function<void(const std::filesystem::path&)>& load)
+{
+    const auto path = std::filesystem::temp_directory_path() / "retro_font_loaders_test";
+    std::ofstream{path, std::ios::binary}.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+
+    auto rejected = false;
+
+    try
+    {
+        load(path);
+    }
+    catch(const std::runtime_error&)
+    {
+        rejected = true;
+    }
+
+    std::filesystem::remove(path);
+    return rejected;
+}
+
+}   // unnamed
+
+
+////////////////////////////////////////////////////////////////////////////////
+int main()
+{
+    const auto psf = [](const auto& path) { static_cast<void>(retro::font::load_psf(path)); };
+    const auto bdf = [](const auto& path) { static_cast<void>(retro::font::load_bdf(path)); };
+    const auto raw = [](const auto& path) { static_cast<void>(retro::font::load_raw(path, 16)); };
+
+    const struct
+    {
+        const char* name;
+        std::string contents;
+        std::function<void(const std::filesystem::path&)> load;
+    } invalid[] = {
+        {"empty PSF", "", psf},
+        {"truncated PSF1 header", std::string{"\x36\x04\x00", 3}, psf},
+        {"truncated PSF1 glyphs", std::string{"\x36\x04\x00\x10", 4} + std::string(100, '\0'), psf},
+        {"zero height PSF1", std::string{"\x36\x04\x00\x00", 4}, psf},
+        {"truncated PSF2 header", psf2(1, 16, 16, 8, 0).substr(0, 28), psf},
+        {"truncated PSF2 glyphs", psf2(2, 16, 16, 8, 16), psf},
+        {"zero size PSF2 glyphs", psf2(1, 0, 1, 8, 8), psf},
+        {"zero height PSF2", psf2(1, 16, 0, 8, 16), psf},
+        {"oversized PSF2 height", psf2(1, 8, 0x80000000u, 8, 8), psf},
+        {"oversized PSF2 glyphs", psf2(0xffffffffu, 0xffffffffu, 16, 8, 16), psf},
+        {"wrapping PSF2 glyph size", psf2(1, 8, 0x40000000u, 32, 8), psf},
+        {"BDF without bounding box", "STARTFONT 2.1\nENDFONT\n", bdf},
+        {"zero size BDF bounding box", "STARTFONT 2.1\nFONTBOUNDINGBOX 0 16 0 0\n", bdf},
+        {"oversized BDF bounding box", "STARTFONT 2.1\nFONTBOUNDINGBOX 8 65536 0 0\n", bdf},
+        {"oversized BDF glyphs", "STARTFONT 2.1\nFONTBOUNDINGBOX 32 65535 0 0\nSTARTCHAR x\nENCODING 65535\n", bdf},
+        {"empty raw font", "", raw},
+        {"truncated raw font", std::string(100, '\0'), raw},
+    };
+
+    for(const auto& [name, contents, load] : invalid)
+    {
+        if(!rejects(contents, load))
+        {
+            std::printf("%s: not rejected\n", name);
+            return EXIT_FAILURE;
+        }
+    }
+
+    // the smallest valid fonts still load
+    if(rejects(psf2(1, 16, 16, 8, 16), psf) ||
+       rejects(std::string{"\x36\x04\x00\x01", 4} + std::string(256, '\0'), psf) ||
+       rejects("STARTFONT 2.1\nFONTBOUNDINGBOX 8 16 0 -4\nENDFONT\n", bdf) ||
+       rejects("STARTFONT 2.1\nFONTBOUNDINGBOX 12 16 0 -4\nENDFONT\n", bdf) ||
+       rejects(std::string(16, '\0'), raw))
+    {
+        std::printf("valid font rejected\n");
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,56 @@
+////////////////////////////////////////////////////////////////////////////////
+// Retro - Retro Computing Library
+// Copyright (c) 2023 Ryan Clarke
+////////////////////////////////////////////////////////////////////////////////
+
+#include <retro/scrollback.hpp>
+
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+
+////////////////////////////////////////////////////////////////////////////////
+int main()
+{
+    constexpr std::size_t columns{80};
+    constexpr std::size_t max_memory{64 * 1024};
+
+    std::vector<retro::text_cell> text(columns);
+    const std::vector<retro::text_cell> blank(columns);
+
+    for(std::size_t col{0}; col < 10; ++col)
+    {
+        text[col] = {static_cast<std::uint16_t>('A' + col), 7, 0};
+    }
+
+    // blank lines take no space in the byte ring, and must not make it grow
+    for(std::size_t depth{1}; depth <= 8; ++depth)
+    {
+        retro::scrollback sb{depth};
+
+        for(std::size_t i{0}; i < 4096; ++i)
+        {
+            const auto& pushed = (i % 2 == 0) ? text : blank;
+            sb.push(pushed);
+
+            std::vector<retro::text_cell> line(columns);
+            sb.line(0, line);
+
+            if(line != pushed)
+            {
+                std::printf("depth %zu push %zu: line does not match\n", depth, i);
+                return EXIT_FAILURE;
+            }
+
+            if(sb.memory_usage() > max_memory)
+            {
+                std::printf("depth %zu push %zu: %zu bytes used\n", depth, i, sb.memory_usage());
+                return EXIT_FAILURE;
+            }
+        }
+    }
+
+    return EXIT_SUCCESS;
+}